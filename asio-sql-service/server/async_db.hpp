@@ -0,0 +1,108 @@
+#pragma once
+
+#include <boost/asio.hpp>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef WITH_POSTGRESQL
+#include "db/PostgreSQLAsyncConnection.h"
+
+namespace asio_sql {
+
+// Drives a PostgreSQLAsyncConnection from a Boost.Asio executor: the libpq
+// socket is wrapped in a stream_descriptor and watched with async_wait, so
+// queries never block an io thread. Many sessions can share one connection
+// and one thread; results complete in submission order.
+class AsyncDbConnection : public std::enable_shared_from_this<AsyncDbConnection> {
+public:
+    using QueryCallback = hft::db::PostgreSQLAsyncConnection::QueryCallback;
+
+    explicit AsyncDbConnection(boost::asio::any_io_executor executor)
+        : descriptor_(executor) {
+    }
+
+    ~AsyncDbConnection() {
+        // libpq owns the socket; do not let asio close it
+        if (descriptor_.is_open()) {
+            descriptor_.release();
+        }
+    }
+
+    bool open(const std::string& connection_string) {
+        // Reopening: drop the old socket before libpq closes it
+        if (descriptor_.is_open()) {
+            descriptor_.release();
+        }
+        if (!conn_.open(connection_string)) {
+            return false;
+        }
+        descriptor_.assign(conn_.socket());
+        return true;
+    }
+
+    bool is_open() const { return conn_.isOpen(); }
+    std::string last_error() const { return conn_.getLastError(); }
+    std::size_t pending() const { return conn_.pending(); }
+
+    void query(const std::string& sql, QueryCallback callback) {
+        query(sql, {}, std::move(callback));
+    }
+
+    void query(const std::string& sql, const std::vector<std::string>& params, QueryCallback callback) {
+        if (!conn_.sendQuery(sql, params, callback)) {
+            callback(nullptr, conn_.getLastError());
+            return;
+        }
+        arm();
+    }
+
+private:
+    void arm() {
+        if (!descriptor_.is_open()) {
+            return;
+        }
+        auto self(shared_from_this());
+        if (!reading_ && conn_.pending() > 0) {
+            reading_ = true;
+            descriptor_.async_wait(boost::asio::posix::stream_descriptor::wait_read,
+                [this, self](boost::system::error_code ec) {
+                    reading_ = false;
+                    if (ec) {
+                        return;
+                    }
+                    if (!conn_.onReadable()) {
+                        std::cerr << "Database connection error: " << conn_.getLastError() << std::endl;
+                        return;
+                    }
+                    arm();
+                });
+        }
+        if (!writing_ && conn_.wantsWrite()) {
+            writing_ = true;
+            descriptor_.async_wait(boost::asio::posix::stream_descriptor::wait_write,
+                [this, self](boost::system::error_code ec) {
+                    writing_ = false;
+                    if (ec) {
+                        return;
+                    }
+                    if (!conn_.onWritable()) {
+                        std::cerr << "Database connection error: " << conn_.getLastError() << std::endl;
+                        return;
+                    }
+                    arm();
+                });
+        }
+    }
+
+    hft::db::PostgreSQLAsyncConnection conn_;
+    boost::asio::posix::stream_descriptor descriptor_;
+    bool reading_ = false;
+    bool writing_ = false;
+};
+
+} // namespace asio_sql
+
+#endif // WITH_POSTGRESQL
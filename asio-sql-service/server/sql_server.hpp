@@ -7,7 +7,7 @@
 #include "../common/protocol.hpp"
 
 #ifdef WITH_POSTGRESQL
-#include "db/PostgreSQLConnection.h"
+#include "async_db.hpp"
 #include "db/IResultSet.h"
 #endif
 
@@ -15,11 +15,23 @@ namespace asio_sql {
 
 using boost::asio::ip::tcp;
 
+#ifdef WITH_POSTGRESQL
+// Connection string used by the server's shared asynchronous connection
+inline const char* DEFAULT_DB_CONNECTION =
+    "host=localhost dbname=testdb user=postgres password=postgres";
+#endif
+
 class Session : public std::enable_shared_from_this<Session> {
 public:
+#ifdef WITH_POSTGRESQL
+    Session(tcp::socket socket, std::shared_ptr<AsyncDbConnection> db)
+        : socket_(std::move(socket)), db_(std::move(db)) {
+    }
+#else
     Session(tcp::socket socket)
         : socket_(std::move(socket)) {
     }
+#endif
 
     void start() {
         read_header();
@@ -101,42 +113,49 @@ private:
         
         try {
 #ifdef WITH_POSTGRESQL
-            // Execute query using PostgreSQL
-            if (!db_connection_) {
-                // Create connection (in real app, use connection pool)
-                db_connection_ = std::make_shared<PostgreSQLConnection>(
-                    "host=localhost dbname=testdb user=postgres password=postgres"
-                );
-                db_connection_->connect();
+            // Runs on the shared non-blocking connection; the io thread is
+            // free until the result arrives
+            if (!ensure_db()) {
+                return;
             }
             
-            auto stmt = db_connection_->createStatement(req.sql);
-            auto result = stmt->executeQuery();
-            
-            RawRowResponse response;
-            
-            // Get column names
-            int col_count = result->getColumnCount();
-            for (int i = 0; i < col_count; ++i) {
-                response.column_names.push_back(result->getColumnName(i));
-            }
-            
-            // Get rows
-            while (result->next()) {
-                std::vector<std::string> row;
-                for (int i = 0; i < col_count; ++i) {
-                    if (result->isNull(i)) {
-                        row.push_back("");
-                    } else {
-                        row.push_back(result->getString(i));
+            auto self(shared_from_this());
+            db_->query(req.sql, [this, self](std::shared_ptr<hft::db::IResultSet> result, const std::string& error) {
+                if (!error.empty()) {
+                    std::cerr << "Query execution error: " << error << std::endl;
+                    send_error(std::string("Query error: ") + error);
+                    return;
+                }
+                try {
+                    RawRowResponse response;
+
+                    // Get column names
+                    int col_count = result->getColumnCount();
+                    for (int i = 0; i < col_count; ++i) {
+                        response.column_names.push_back(result->getColumnName(i));
+                    }
+
+                    // Get rows
+                    while (result->next()) {
+                        std::vector<std::string> row;
+                        for (int i = 0; i < col_count; ++i) {
+                            if (result->isNull(i)) {
+                                row.push_back("");
+                            } else {
+                                row.push_back(result->getString(i));
+                            }
+                        }
+                        response.rows.push_back(row);
                     }
+
+                    std::cout << "Query returned " << response.rows.size() << " rows" << std::endl;
+
+                    send_response(MessageType::RESPONSE_RAW, response.serialize());
+                } catch (const std::exception& e) {
+                    std::cerr << "Query execution error: " << e.what() << std::endl;
+                    send_error(std::string("Query error: ") + e.what());
                 }
-                response.rows.push_back(row);
-            }
-            
-            std::cout << "Query returned " << response.rows.size() << " rows" << std::endl;
-            
-            send_response(MessageType::RESPONSE_RAW, response.serialize());
+            });
 #else
             // Mock response when PostgreSQL is not available
             RawRowResponse response;
@@ -162,39 +181,48 @@ private:
         
         try {
 #ifdef WITH_POSTGRESQL
-            if (!db_connection_) {
-                db_connection_ = std::make_shared<PostgreSQLConnection>(
-                    "host=localhost dbname=testdb user=postgres password=postgres"
-                );
-                db_connection_->connect();
+            // Runs on the shared non-blocking connection; the io thread is
+            // free until the result arrives
+            if (!ensure_db()) {
+                return;
             }
             
-            auto stmt = db_connection_->createStatement(req.sql);
-            auto result = stmt->executeQuery();
-            
-            nlohmann::json json_array = nlohmann::json::array();
-            
-            int col_count = result->getColumnCount();
-            
-            while (result->next()) {
-                nlohmann::json row_obj;
-                for (int i = 0; i < col_count; ++i) {
-                    std::string col_name = result->getColumnName(i);
-                    if (result->isNull(i)) {
-                        row_obj[col_name] = nullptr;
-                    } else {
-                        row_obj[col_name] = result->getString(i);
+            auto self(shared_from_this());
+            db_->query(req.sql, [this, self](std::shared_ptr<hft::db::IResultSet> result, const std::string& error) {
+                if (!error.empty()) {
+                    std::cerr << "Query execution error: " << error << std::endl;
+                    send_error(std::string("Query error: ") + error);
+                    return;
+                }
+                try {
+                    nlohmann::json json_array = nlohmann::json::array();
+
+                    int col_count = result->getColumnCount();
+
+                    while (result->next()) {
+                        nlohmann::json row_obj;
+                        for (int i = 0; i < col_count; ++i) {
+                            std::string col_name = result->getColumnName(i);
+                            if (result->isNull(i)) {
+                                row_obj[col_name] = nullptr;
+                            } else {
+                                row_obj[col_name] = result->getString(i);
+                            }
+                        }
+                        json_array.push_back(row_obj);
                     }
+
+                    JsonResponse response;
+                    response.data = json_array;
+
+                    std::cout << "Query returned " << json_array.size() << " rows as JSON" << std::endl;
+
+                    send_response(MessageType::RESPONSE_JSON, response.serialize());
+                } catch (const std::exception& e) {
+                    std::cerr << "Query execution error: " << e.what() << std::endl;
+                    send_error(std::string("Query error: ") + e.what());
                 }
-                json_array.push_back(row_obj);
-            }
-            
-            JsonResponse response;
-            response.data = json_array;
-            
-            std::cout << "Query returned " << json_array.size() << " rows as JSON" << std::endl;
-            
-            send_response(MessageType::RESPONSE_JSON, response.serialize());
+            });
 #else
             // Mock JSON response
             nlohmann::json json_array = nlohmann::json::array();
@@ -226,61 +254,72 @@ private:
             // [num_rows: 4 bytes][num_cols: 4 bytes]
             // For each row: [col1_len: 4 bytes][col1_data][col2_len: 4 bytes][col2_data]...
             
-            std::vector<uint8_t> binary_data;
-            
 #ifdef WITH_POSTGRESQL
-            if (!db_connection_) {
-                db_connection_ = std::make_shared<PostgreSQLConnection>(
-                    "host=localhost dbname=testdb user=postgres password=postgres"
-                );
-                db_connection_->connect();
+            // Runs on the shared non-blocking connection; the io thread is
+            // free until the result arrives
+            if (!ensure_db()) {
+                return;
             }
             
-            auto stmt = db_connection_->createStatement(req.sql);
-            auto result = stmt->executeQuery();
-            
-            int col_count = result->getColumnCount();
-            std::vector<std::vector<std::string>> rows;
-            
-            while (result->next()) {
-                std::vector<std::string> row;
-                for (int i = 0; i < col_count; ++i) {
-                    row.push_back(result->isNull(i) ? "" : result->getString(i));
+            auto self(shared_from_this());
+            db_->query(req.sql, [this, self](std::shared_ptr<hft::db::IResultSet> result, const std::string& error) {
+                if (!error.empty()) {
+                    std::cerr << "Binary query error: " << error << std::endl;
+                    send_error(std::string("Binary query error: ") + error);
+                    return;
                 }
-                rows.push_back(row);
-            }
-            
-            // Serialize to binary
-            uint32_t num_rows = static_cast<uint32_t>(rows.size());
-            uint32_t num_cols = static_cast<uint32_t>(col_count);
-            
-            // Write num_rows (big-endian)
-            binary_data.push_back((num_rows >> 24) & 0xFF);
-            binary_data.push_back((num_rows >> 16) & 0xFF);
-            binary_data.push_back((num_rows >> 8) & 0xFF);
-            binary_data.push_back(num_rows & 0xFF);
-            
-            // Write num_cols
-            binary_data.push_back((num_cols >> 24) & 0xFF);
-            binary_data.push_back((num_cols >> 16) & 0xFF);
-            binary_data.push_back((num_cols >> 8) & 0xFF);
-            binary_data.push_back(num_cols & 0xFF);
-            
-            // Write each cell
-            for (const auto& row : rows) {
-                for (const auto& cell : row) {
-                    uint32_t len = static_cast<uint32_t>(cell.size());
-                    binary_data.push_back((len >> 24) & 0xFF);
-                    binary_data.push_back((len >> 16) & 0xFF);
-                    binary_data.push_back((len >> 8) & 0xFF);
-                    binary_data.push_back(len & 0xFF);
-                    binary_data.insert(binary_data.end(), cell.begin(), cell.end());
+                try {
+                    std::vector<uint8_t> binary_data;
+                    int col_count = result->getColumnCount();
+                    std::vector<std::vector<std::string>> rows;
+
+                    while (result->next()) {
+                        std::vector<std::string> row;
+                        for (int i = 0; i < col_count; ++i) {
+                            row.push_back(result->isNull(i) ? "" : result->getString(i));
+                        }
+                        rows.push_back(row);
+                    }
+
+                    // Serialize to binary
+                    uint32_t num_rows = static_cast<uint32_t>(rows.size());
+                    uint32_t num_cols = static_cast<uint32_t>(col_count);
+
+                    // Write num_rows (big-endian)
+                    binary_data.push_back((num_rows >> 24) & 0xFF);
+                    binary_data.push_back((num_rows >> 16) & 0xFF);
+                    binary_data.push_back((num_rows >> 8) & 0xFF);
+                    binary_data.push_back(num_rows & 0xFF);
+
+                    // Write num_cols
+                    binary_data.push_back((num_cols >> 24) & 0xFF);
+                    binary_data.push_back((num_cols >> 16) & 0xFF);
+                    binary_data.push_back((num_cols >> 8) & 0xFF);
+                    binary_data.push_back(num_cols & 0xFF);
+
+                    // Write each cell
+                    for (const auto& row : rows) {
+                        for (const auto& cell : row) {
+                            uint32_t len = static_cast<uint32_t>(cell.size());
+                            binary_data.push_back((len >> 24) & 0xFF);
+                            binary_data.push_back((len >> 16) & 0xFF);
+                            binary_data.push_back((len >> 8) & 0xFF);
+                            binary_data.push_back(len & 0xFF);
+                            binary_data.insert(binary_data.end(), cell.begin(), cell.end());
+                        }
+                    }
+
+                    std::cout << "Binary response size: " << binary_data.size() << " bytes" << std::endl;
+
+                    send_response_binary(MessageType::RESPONSE_BINARY, binary_data);
+                } catch (const std::exception& e) {
+                    std::cerr << "Binary query error: " << e.what() << std::endl;
+                    send_error(std::string("Binary query error: ") + e.what());
                 }
-            }
-            
-            std::cout << "Binary response size: " << binary_data.size() << " bytes" << std::endl;
+            });
 #else
             // Mock binary data
+            std::vector<uint8_t> binary_data;
             uint32_t num_rows = 2;
             uint32_t num_cols = 3;
             
@@ -304,10 +343,9 @@ private:
                 binary_data.push_back(len & 0xFF);
                 binary_data.insert(binary_data.end(), cell.begin(), cell.end());
             }
-#endif
             
             send_response_binary(MessageType::RESPONSE_BINARY, binary_data);
-            
+#endif
         } catch (const std::exception& e) {
             std::cerr << "Binary query error: " << e.what() << std::endl;
             send_error(std::string("Binary query error: ") + e.what());
@@ -325,63 +363,72 @@ private:
         
         try {
 #ifdef WITH_POSTGRESQL
-            if (!db_connection_) {
-                db_connection_ = std::make_shared<PostgreSQLConnection>(
-                    "host=localhost dbname=testdb user=postgres password=postgres"
-                );
-                db_connection_->connect();
-            }
-            
-            auto stmt = db_connection_->createStatement(req.sql);
-            auto result = stmt->executeQuery();
-            
-            nlohmann::json stream_response = nlohmann::json::array();
-            
-            int col_count = result->getColumnCount();
-            
-            // Get column names
-            nlohmann::json columns = nlohmann::json::array();
-            for (int i = 0; i < col_count; ++i) {
-                columns.push_back(result->getColumnName(i));
+            // Runs on the shared non-blocking connection; the io thread is
+            // free until the result arrives
+            if (!ensure_db()) {
+                return;
             }
             
-            // Send metadata first
-            nlohmann::json metadata;
-            metadata["type"] = "metadata";
-            metadata["columns"] = columns;
-            stream_response.push_back(metadata);
-            
-            // Then send each row as a separate "chunk"
-            int row_count = 0;
-            while (result->next()) {
-                nlohmann::json row_chunk;
-                row_chunk["type"] = "row";
-                row_chunk["index"] = row_count++;
-                
-                nlohmann::json row_data = nlohmann::json::array();
-                for (int i = 0; i < col_count; ++i) {
-                    if (result->isNull(i)) {
-                        row_data.push_back(nullptr);
-                    } else {
-                        row_data.push_back(result->getString(i));
+            auto self(shared_from_this());
+            db_->query(req.sql, [this, self](std::shared_ptr<hft::db::IResultSet> result, const std::string& error) {
+                if (!error.empty()) {
+                    std::cerr << "Stream query error: " << error << std::endl;
+                    send_error(std::string("Stream query error: ") + error);
+                    return;
+                }
+                try {
+                    nlohmann::json stream_response = nlohmann::json::array();
+
+                    int col_count = result->getColumnCount();
+
+                    // Get column names
+                    nlohmann::json columns = nlohmann::json::array();
+                    for (int i = 0; i < col_count; ++i) {
+                        columns.push_back(result->getColumnName(i));
+                    }
+
+                    // Send metadata first
+                    nlohmann::json metadata;
+                    metadata["type"] = "metadata";
+                    metadata["columns"] = columns;
+                    stream_response.push_back(metadata);
+
+                    // Then send each row as a separate "chunk"
+                    int row_count = 0;
+                    while (result->next()) {
+                        nlohmann::json row_chunk;
+                        row_chunk["type"] = "row";
+                        row_chunk["index"] = row_count++;
+
+                        nlohmann::json row_data = nlohmann::json::array();
+                        for (int i = 0; i < col_count; ++i) {
+                            if (result->isNull(i)) {
+                                row_data.push_back(nullptr);
+                            } else {
+                                row_data.push_back(result->getString(i));
+                            }
+                        }
+                        row_chunk["data"] = row_data;
+                        stream_response.push_back(row_chunk);
                     }
+
+                    // Send end marker
+                    nlohmann::json end_marker;
+                    end_marker["type"] = "end";
+                    end_marker["total_rows"] = row_count;
+                    stream_response.push_back(end_marker);
+
+                    JsonResponse response;
+                    response.data = stream_response;
+
+                    std::cout << "Streamed " << row_count << " rows" << std::endl;
+
+                    send_response(MessageType::RESPONSE_STREAM, response.serialize());
+                } catch (const std::exception& e) {
+                    std::cerr << "Stream query error: " << e.what() << std::endl;
+                    send_error(std::string("Stream query error: ") + e.what());
                 }
-                row_chunk["data"] = row_data;
-                stream_response.push_back(row_chunk);
-            }
-            
-            // Send end marker
-            nlohmann::json end_marker;
-            end_marker["type"] = "end";
-            end_marker["total_rows"] = row_count;
-            stream_response.push_back(end_marker);
-            
-            JsonResponse response;
-            response.data = stream_response;
-            
-            std::cout << "Streamed " << row_count << " rows" << std::endl;
-            
-            send_response(MessageType::RESPONSE_STREAM, response.serialize());
+            });
 #else
             // Mock stream response
             nlohmann::json stream_response = nlohmann::json::array();
@@ -418,6 +465,17 @@ private:
         }
     }
 
+#ifdef WITH_POSTGRESQL
+    bool ensure_db() {
+        if (db_->is_open() || db_->open(DEFAULT_DB_CONNECTION)) {
+            return true;
+        }
+        std::cerr << "Database connection failed: " << db_->last_error() << std::endl;
+        send_error("Database connection failed: " + db_->last_error());
+        return false;
+    }
+#endif
+
     void send_response(MessageType type, const std::string& payload) {
         MessageHeader header;
         header.message_type = static_cast<uint8_t>(type);
@@ -474,14 +532,18 @@ private:
     std::vector<uint8_t> payload_buffer_;
     
 #ifdef WITH_POSTGRESQL
-    std::shared_ptr<PostgreSQLConnection> db_connection_;
+    std::shared_ptr<AsyncDbConnection> db_;
 #endif
 };
 
 class SqlServer {
 public:
     SqlServer(boost::asio::io_context& io_context, short port)
-        : acceptor_(io_context, tcp::endpoint(tcp::v4(), port)) {
+        : acceptor_(io_context, tcp::endpoint(tcp::v4(), port))
+#ifdef WITH_POSTGRESQL
+        , db_(std::make_shared<AsyncDbConnection>(io_context.get_executor()))
+#endif
+    {
         accept();
     }
 
@@ -492,7 +554,11 @@ private:
                 if (!ec) {
                     std::cout << "Client connected from " 
                               << socket.remote_endpoint() << std::endl;
+#ifdef WITH_POSTGRESQL
+                    std::make_shared<Session>(std::move(socket), db_)->start();
+#else
                     std::make_shared<Session>(std::move(socket))->start();
+#endif
                 }
                 
                 accept();
@@ -500,6 +566,10 @@ private:
     }
 
     tcp::acceptor acceptor_;
+#ifdef WITH_POSTGRESQL
+    // One non-blocking connection shared by every session on this io_context
+    std::shared_ptr<AsyncDbConnection> db_;
+#endif
 };
 
 } // namespace asio_sql
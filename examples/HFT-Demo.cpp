@@ -349,7 +349,8 @@ bool testDBReader(std::shared_ptr<IConnection> conn, const std::string& dbType)
 }
 
 // Test JSON export
-bool testJSONExport(std::shared_ptr<IConnection> conn, const std::string& tableName, const std::string& outputFile) {
+bool testJSONExport(std::shared_ptr<IConnection> conn, const std::string& tableName, const std::string& outputFile,
+                    int fetchSize) {
     printSeparator("Testing JSON Export");
     
     try {
@@ -361,9 +362,9 @@ bool testJSONExport(std::shared_ptr<IConnection> conn, const std::string& tableN
         
         std::cout << "Exporting table '" << tableName << "' to JSON..." << std::endl;
         
-        // Use validated identifier in query (safe after validation)
-        auto stmt = conn->createStatement("SELECT * FROM " + tableName);
-        auto result = stmt->executeQuery();
+        // Use validated identifier in query (safe after validation).
+        // Rows are paged through a server-side cursor where supported.
+        auto result = conn->openCursor("SELECT * FROM " + tableName, fetchSize);
         
         if (!result) {
             std::cerr << "Failed to query table" << std::endl;
@@ -441,6 +442,7 @@ int main(int argc, char* argv[]) {
             ("test-json", "Test JSON export", cxxopts::value<std::string>()->implicit_value("products"))
             ("d,details", "Show detailed information (for catalog)")
             ("o,output", "Output file path", cxxopts::value<std::string>()->default_value("output.json"))
+            ("fetch-size", "Rows fetched per round trip (JSON export)", cxxopts::value<int>()->default_value("1000"))
             ("h,help", "Print usage");
         
         auto result = options.parse(argc, argv);
@@ -568,7 +570,8 @@ int main(int argc, char* argv[]) {
             std::cout << "tableName " << tableName << std::endl;
             std::string outputFile = result["output"].as<std::string>();
             std::cout << "outputFile " << outputFile << std::endl;
-            success = testJSONExport(conn, tableName, outputFile) && success;
+            int fetchSize = result["fetch-size"].as<int>();
+            success = testJSONExport(conn, tableName, outputFile, fetchSize) && success;
         }
         
         if (conn) {
@@ -1,12 +1,13 @@
 #pragma once
 
+#include "IStatement.h"
 #include <memory>
 #include <string>
 
 namespace hft {
 namespace db {
 
-class IStatement;
+class IResultSet;
 class ITransaction;
 
 /**
@@ -54,6 +55,26 @@ public:
      */
     virtual bool execute(const std::string& sql) = 0;
 
+    /**
+     * @brief Run a query through a server-side cursor, fetchSize rows at a time
+     *
+     * Backends without cursors return the fully buffered result.
+     * @param sql SELECT query
+     * @param fetchSize Rows fetched per round trip
+     * @return Shared pointer to result set, or nullptr on failure
+     */
+    virtual std::shared_ptr<IResultSet> openCursor(const std::string& sql, int fetchSize) {
+        (void)fetchSize;
+        auto stmt = createStatement(sql);
+        return stmt ? stmt->executeQuery() : nullptr;
+    }
+
+    /**
+     * @brief Whether "= ANY($n::type[])" with an array literal bound
+     *        through bindString() is understood by the server
+     */
+    virtual bool supportsArrayParameters() const { return false; }
+
     /**
      * @brief Get last error message
      * @return Error message string
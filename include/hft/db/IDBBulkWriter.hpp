@@ -0,0 +1,20 @@
+#pragma once
+#include <string>
+
+// Streaming bulk loader (e.g. PostgreSQL COPY FROM STDIN). Each row is
+// opened with startRow() and then receives exactly one write per column,
+// in the column order given to IDBConnection::beginBulkInsert().
+// finish() completes the load and returns the number of rows loaded;
+// destroying an unfinished writer aborts the load.
+class IDBBulkWriter {
+public:
+    virtual ~IDBBulkWriter() = default;
+
+    virtual void startRow() = 0;
+    virtual void writeNull() = 0;
+    virtual void writeInt(int value) = 0;
+    virtual void writeDouble(double value) = 0;
+    virtual void writeString(const std::string& value) = 0;
+
+    virtual long finish() = 0;
+};
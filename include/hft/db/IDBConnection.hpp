@@ -1,11 +1,21 @@
 #pragma once
+#include "db/IDBReader.hpp"
+#include "db/IDBPipeline.hpp"
+#include "db/IDBBulkWriter.hpp"
 #include <memory>
 #include <string>
+#include <vector>
 
-class IDBReader;
 class IDBPreparedStatement;
 class IDBTransaction;
 
+// How executeStreamingQuery() pulls rows from the server
+enum class FetchMode {
+    Buffered,   // whole result set buffered client-side (same as executeQuery)
+    SingleRow,  // rows streamed as they arrive; fetchSize rows per chunk where supported
+    Cursor      // server-side cursor paged with FETCH FORWARD fetchSize
+};
+
 class IDBConnection {
 public:
     virtual ~IDBConnection() = default;
@@ -13,9 +23,36 @@ public:
     virtual std::unique_ptr<IDBReader>
     executeQuery(const std::string& sql) = 0;
 
+    // Per-query fetch strategy for large result sets. Backends without a
+    // streaming mode fall back to a buffered executeQuery().
+    virtual std::unique_ptr<IDBReader>
+    executeStreamingQuery(const std::string& sql, FetchMode mode, int fetchSize) {
+        (void)mode;
+        (void)fetchSize;
+        return executeQuery(sql);
+    }
+
     virtual std::unique_ptr<IDBPreparedStatement>
     prepare(const std::string& sql) = 0;
 
     virtual std::unique_ptr<IDBTransaction>
     beginTransaction() = 0;
+
+    // Batch statements into as few round trips as possible (see
+    // IDBPipeline). Returns nullptr when the backend has no pipelining.
+    virtual std::unique_ptr<IDBPipeline>
+    beginPipeline() { return nullptr; }
+
+    // True when IDBPreparedStatement array binds arrive as real arrays the
+    // server can use in "= ANY($n)"; false for the text-literal default
+    virtual bool supportsArrayParameters() const { return false; }
+
+    // Bulk-load rows into table(columns) (see IDBBulkWriter). Returns
+    // nullptr when the backend has no bulk path.
+    virtual std::unique_ptr<IDBBulkWriter>
+    beginBulkInsert(const std::string& table, const std::vector<std::string>& columns) {
+        (void)table;
+        (void)columns;
+        return nullptr;
+    }
 };
@@ -0,0 +1,23 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Outcome of one statement queued on a pipeline
+struct DBPipelineResult {
+    bool ok{false};
+    long affectedRows{0};
+    std::string error;
+};
+
+// While a pipeline is open, IDBPreparedStatement::executeUpdate() on its
+// connection queues the statement instead of waiting for the server.
+// sync() flushes the queue and returns one result per statement, in the
+// order they were queued. Closing the pipeline (destruction) syncs any
+// remaining work and discards the results.
+class IDBPipeline {
+public:
+    virtual ~IDBPipeline() = default;
+    virtual std::size_t pending() const = 0;
+    virtual std::vector<DBPipelineResult> sync() = 0;
+};
@@ -1,6 +1,10 @@
 #pragma once
+#include <iomanip>
+#include <limits>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <vector>
 
 class IDBReader;
 
@@ -12,6 +16,41 @@ public:
     virtual void bindDouble(int index, double value) = 0;
     virtual void bindString(int index, const std::string& value) = 0;
 
+    // One-dimensional array parameters (PostgreSQL int4[], float8[], text[]).
+    // The default sends an array literal through bindString(); drivers with
+    // a binary protocol override these.
+    virtual void bindIntArray(int index, const std::vector<int>& values) {
+        std::ostringstream oss;
+        oss << '{';
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            oss << (i ? "," : "") << values[i];
+        }
+        oss << '}';
+        bindString(index, oss.str());
+    }
+    virtual void bindDoubleArray(int index, const std::vector<double>& values) {
+        std::ostringstream oss;
+        oss << std::setprecision(std::numeric_limits<double>::max_digits10) << '{';
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            oss << (i ? "," : "") << values[i];
+        }
+        oss << '}';
+        bindString(index, oss.str());
+    }
+    virtual void bindStringArray(int index, const std::vector<std::string>& values) {
+        std::string literal = "{";
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            literal += i ? ",\"" : "\"";
+            for (char c : values[i]) {
+                if (c == '"' || c == '\\') literal += '\\';
+                literal += c;
+            }
+            literal += '"';
+        }
+        literal += '}';
+        bindString(index, literal);
+    }
+
     virtual std::unique_ptr<IDBReader> executeQuery() = 0;
     virtual void executeUpdate() = 0;
 };
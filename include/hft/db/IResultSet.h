@@ -1,7 +1,10 @@
 #pragma once
 
+#include "ResultMetadata.h"
 #include <string>
+#include <string_view>
 #include <cstdint>
+#include <memory>
 
 namespace hft {
 namespace db {
@@ -66,6 +69,62 @@ public:
      * @return Column name
      */
     virtual std::string getColumnName(int index) const = 0;
+
+    /**
+     * @brief Get column metadata (names, types, name index)
+     *
+     * The default builds a fresh object from getColumnCount() and
+     * getColumnName(); drivers override it to return metadata computed
+     * once and shared across rows, pages and executions.
+     * @return Metadata, never null
+     */
+    virtual std::shared_ptr<const ResultMetadata> getMetadata() const {
+        std::vector<ColumnInfo> columns(getColumnCount());
+        for (int i = 0; i < static_cast<int>(columns.size()); ++i) {
+            columns[i].name = getColumnName(i);
+        }
+        return std::make_shared<const ResultMetadata>(std::move(columns));
+    }
+
+    /**
+     * @brief Resolve a column name to its index
+     * @param name Column name (exact match)
+     * @return Column index (0-based), or -1 if not found
+     */
+    virtual int findColumn(std::string_view name) const {
+        return getMetadata()->findColumn(name);
+    }
+
+    /**
+     * @brief Get values by column name
+     *
+     * Each call is one hash lookup; for tight loops resolve the index once
+     * with findColumn(). A missing column reads as NULL.
+     */
+    int32_t getInt(std::string_view name) const {
+        int index = findColumn(name);
+        return index < 0 ? 0 : getInt(index);
+    }
+
+    int64_t getLong(std::string_view name) const {
+        int index = findColumn(name);
+        return index < 0 ? 0 : getLong(index);
+    }
+
+    double getDouble(std::string_view name) const {
+        int index = findColumn(name);
+        return index < 0 ? 0.0 : getDouble(index);
+    }
+
+    std::string getString(std::string_view name) const {
+        int index = findColumn(name);
+        return index < 0 ? std::string() : getString(index);
+    }
+
+    bool isNull(std::string_view name) const {
+        int index = findColumn(name);
+        return index < 0 || isNull(index);
+    }
 };
 
 } // namespace db
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "IResultSet.h"
+#include <libpq-fe.h>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace hft {
+namespace db {
+
+/**
+ * @brief Non-blocking PostgreSQL connection driven by an event loop
+ *
+ * Queries are sent with PQsendQueryParams in libpq pipeline mode, each
+ * followed by its own sync point, so any number of them can be in flight
+ * on one connection and an error only fails its own query. Nothing here
+ * blocks after open(): the owner watches socket() with its event loop
+ * (select/epoll, boost::asio::posix::stream_descriptor, ...) and calls
+ * onReadable() / onWritable() when the descriptor is ready. Callbacks and
+ * futures complete from inside onReadable(), in submission order.
+ *
+ * Not thread-safe: use one connection per event-loop thread.
+ */
+class PostgreSQLAsyncConnection {
+public:
+    /**
+     * @brief Completion handler; error is empty on success
+     */
+    using QueryCallback = std::function<void(std::shared_ptr<IResultSet> result, const std::string& error)>;
+
+    PostgreSQLAsyncConnection();
+    ~PostgreSQLAsyncConnection();
+
+    PostgreSQLAsyncConnection(const PostgreSQLAsyncConnection&) = delete;
+    PostgreSQLAsyncConnection& operator=(const PostgreSQLAsyncConnection&) = delete;
+
+    /**
+     * @brief Connect (blocking), then switch to non-blocking pipeline mode
+     * @param connectionString libpq connection string
+     * @return true if successful, false otherwise
+     */
+    bool open(const std::string& connectionString);
+
+    /**
+     * @brief Close the connection; pending queries fail with an error
+     */
+    void close();
+
+    bool isOpen() const;
+    std::string getLastError() const;
+
+    /**
+     * @brief Socket descriptor to watch for readiness, or -1 when closed
+     */
+    int socket() const;
+
+    /**
+     * @brief Queue a query; callback runs once its result has arrived
+     * @param sql SQL text with $1..$n placeholders
+     * @param params Text-format parameter values
+     * @param callback Completion handler
+     * @return false if the query could not be sent (callback is not called)
+     */
+    bool sendQuery(const std::string& sql, const std::vector<std::string>& params, QueryCallback callback);
+
+    /**
+     * @brief Queue a query and return a future for its result
+     *
+     * The future holds a std::runtime_error if the query fails. It only
+     * becomes ready while the event loop keeps calling onReadable().
+     */
+    std::future<std::shared_ptr<IResultSet>> sendQuery(const std::string& sql,
+                                                       const std::vector<std::string>& params = {});
+
+    /**
+     * @brief Read available input and complete finished queries
+     * @return false if the connection failed
+     */
+    bool onReadable();
+
+    /**
+     * @brief Send buffered output
+     * @return false if the connection failed
+     */
+    bool onWritable();
+
+    /**
+     * @brief True while queued output still has to be flushed
+     */
+    bool wantsWrite() const { return wantsWrite_; }
+
+    /**
+     * @brief Number of queries whose results have not arrived yet
+     */
+    std::size_t pending() const { return pending_.size(); }
+
+private:
+    struct PendingQuery {
+        QueryCallback callback;
+        PGresult* result{nullptr};
+        std::string error;
+    };
+
+    bool flush();
+    void failAll(const std::string& error);
+
+    PGconn* conn_;
+    std::string lastError_;
+    std::deque<PendingQuery> pending_;
+    bool wantsWrite_;
+};
+
+} // namespace db
+} // namespace hft
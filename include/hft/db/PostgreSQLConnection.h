@@ -5,14 +5,94 @@
 #include "IResultSet.h"
 #include "ITransaction.h"
 #include <libpq-fe.h>
+#include <cstddef>
+#include <cstdint>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace hft {
 namespace db {
 
 class PostgreSQLStatement;
 class PostgreSQLTransaction;
+class PostgreSQLResultSet;
+
+/**
+ * @brief Per-connection registry of server-side prepared statements
+ *
+ * Maps SQL text plus parameter type OIDs to a single named prepared
+ * statement, so every PostgreSQLStatement created for the same query
+ * shares one server-side plan instead of preparing its own copy. The
+ * registry is bounded: once capacity is exceeded the least recently used
+ * statement is DEALLOCATEd. Statements are looked up on every execution,
+ * so an evicted entry is transparently prepared again.
+ */
+class PostgreSQLStatementRegistry {
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 256;
+
+    PostgreSQLStatementRegistry();
+
+    /**
+     * @brief Find or prepare the statement for sql with the given parameter types
+     * @param name Receives the server-side statement name
+     * @param error Receives the server error message on failure
+     * @return false if PQprepare failed
+     */
+    bool acquire(PGconn* conn, const std::string& sql, const std::vector<Oid>& types,
+                 std::string& name, std::string& error);
+
+    /**
+     * @brief Change the bound, deallocating the oldest statements if needed
+     * @note A capacity of 0 is treated as 1
+     */
+    void setCapacity(PGconn* conn, std::size_t capacity);
+    std::size_t capacity() const;
+    std::size_t size() const;
+
+    uint64_t hits() const;
+    uint64_t misses() const;
+    uint64_t evictions() const;
+
+    /**
+     * @brief Server error from the most recent DEALLOCATE that failed
+     *
+     * A statement that could not be deallocated stays in the registry,
+     * temporarily above capacity, and is retried on the next eviction.
+     */
+    std::string lastEvictionError() const;
+
+    /**
+     * @brief Forget all entries without deallocating them
+     *
+     * Used when the session is opened or closed; server-side prepared
+     * statements do not outlive the session.
+     */
+    void reset();
+
+private:
+    struct Entry {
+        std::string key;
+        std::string name;
+    };
+
+    static std::string makeKey(const std::string& sql, const std::vector<Oid>& types);
+    void evictOverflow(PGconn* conn);
+
+    mutable std::mutex mutex_;
+    std::list<Entry> entries_;   // most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    std::size_t capacity_;
+    uint64_t nameCounter_;
+    uint64_t hits_;
+    uint64_t misses_;
+    uint64_t evictions_;
+    std::string evictionError_;
+};
 
 /**
  * @brief PostgreSQL connection implementation
@@ -28,22 +108,39 @@ public:
     std::shared_ptr<IStatement> createStatement(const std::string& sql) override;
     std::shared_ptr<ITransaction> beginTransaction() override;
     bool execute(const std::string& sql) override;
+    std::shared_ptr<IResultSet> openCursor(const std::string& sql, int fetchSize) override;
+    bool supportsArrayParameters() const override { return true; }
     std::string getLastError() const override;
 
     PGconn* getHandle() { return conn_; }
+    PostgreSQLStatementRegistry& statementRegistry() { return statements_; }
 
 private:
+    friend class PostgreSQLStatement;
+    friend class PostgreSQLCursorResultSet;
+
     PGconn* conn_;
     std::string lastError_;
+    unsigned long cursorCounter_;
+    PostgreSQLStatementRegistry statements_;
 };
 
 /**
  * @brief PostgreSQL prepared statement implementation
+ *
+ * Integer and double parameters are sent in binary format (network byte
+ * order, explicit int4/int8/float8 OIDs) from a fixed 8-byte slot per
+ * parameter, so executing does no formatting and the server does no text
+ * parsing. Strings are sent as text with an unspecified type so the server
+ * still infers it from the SQL. The server-side statement is obtained from
+ * the connection's PostgreSQLStatementRegistry on each execution, keyed by
+ * SQL text and bound parameter types, so statements sharing a query share
+ * one plan and a change of parameter types selects a different entry.
  */
 class PostgreSQLStatement : public IStatement {
 public:
     PostgreSQLStatement(PostgreSQLConnection* conn, const std::string& sql);
-    ~PostgreSQLStatement() override;
+    ~PostgreSQLStatement() override = default;
 
     void bindInt(int index, int32_t value) override;
     void bindLong(int index, int64_t value) override;
@@ -55,24 +152,49 @@ public:
     void reset() override;
 
 private:
+    static constexpr std::size_t PARAM_SLOT_SIZE = 8;
+
+    void ensureParam(int index);
+    char* bindBinary(int index, Oid type, int length);
+    PGresult* execPrepared();
+
     PostgreSQLConnection* conn_;
     std::string sql_;
-    std::string stmtName_;
-    std::vector<std::string> paramValues_;
+    std::string stmtName_;   // registry name for the current execution
+    std::vector<std::string> paramValues_;   // text parameters
+    std::vector<char> paramBuffer_;          // binary parameters, PARAM_SLOT_SIZE bytes each
+    std::vector<char> paramNulls_;
     std::vector<int> paramLengths_;
     std::vector<int> paramFormats_;
+    std::vector<Oid> paramTypes_;
     std::vector<const char*> paramPointers_;
-    bool prepared_;
+    std::shared_ptr<const ResultMetadata> metadata_;   // shape of stmtName_'s result
+    std::string metadataName_;
 };
 
 /**
  * @brief PostgreSQL result set implementation
+ *
+ * Column metadata is either supplied by the creator (a statement or cursor
+ * that already described the same result shape) or computed once from the
+ * PGresult on construction.
  */
 class PostgreSQLResultSet : public IResultSet {
 public:
-    PostgreSQLResultSet(PGresult* result);
+    PostgreSQLResultSet(PGresult* result, std::shared_ptr<const ResultMetadata> metadata = nullptr);
     ~PostgreSQLResultSet() override;
 
+    /**
+     * @brief Build metadata (names, OIDs, type modifiers) for a result
+     */
+    static std::shared_ptr<const ResultMetadata> describe(const PGresult* result);
+
+    using IResultSet::getInt;
+    using IResultSet::getLong;
+    using IResultSet::getDouble;
+    using IResultSet::getString;
+    using IResultSet::isNull;
+
     bool next() override;
     int32_t getInt(int index) const override;
     int64_t getLong(int index) const override;
@@ -81,11 +203,70 @@ public:
     bool isNull(int index) const override;
     int getColumnCount() const override;
     std::string getColumnName(int index) const override;
+    std::shared_ptr<const ResultMetadata> getMetadata() const override;
+    int findColumn(std::string_view name) const override;
 
 private:
     PGresult* result_;
     int currentRow_;
     int rowCount_;
+    std::shared_ptr<const ResultMetadata> metadata_;
+};
+
+/**
+ * @brief Result set paged through a server-side cursor
+ *
+ * Declares "NO SCROLL CURSOR FOR sql" and refills its page with
+ * FETCH FORWARD fetchSize as next() advances, so only one page is held
+ * client-side, and column metadata is described once for all pages. Cursors live inside a transaction: if none is open, the
+ * result set begins one and commits it when destroyed.
+ */
+class PostgreSQLCursorResultSet : public IResultSet {
+public:
+    PostgreSQLCursorResultSet(PostgreSQLConnection* conn, const std::string& cursorName, int fetchSize);
+    ~PostgreSQLCursorResultSet() override;
+
+    /**
+     * @brief Declare the cursor and fetch the first page
+     * @return false on failure (see PostgreSQLConnection::getLastError)
+     */
+    bool open(const std::string& sql);
+
+    using IResultSet::getInt;
+    using IResultSet::getLong;
+    using IResultSet::getDouble;
+    using IResultSet::getString;
+    using IResultSet::isNull;
+
+    /**
+     * @brief Advance, fetching the next page when the current one is used up
+     * @throws std::runtime_error if a FETCH fails, so a server error is not
+     *         mistaken for the end of the data; the message is also kept in
+     *         PostgreSQLConnection::getLastError
+     */
+    bool next() override;
+    int32_t getInt(int index) const override;
+    int64_t getLong(int index) const override;
+    double getDouble(int index) const override;
+    std::string getString(int index) const override;
+    bool isNull(int index) const override;
+    int getColumnCount() const override;
+    std::string getColumnName(int index) const override;
+    std::shared_ptr<const ResultMetadata> getMetadata() const override;
+    int findColumn(std::string_view name) const override;
+
+private:
+    bool fetch();
+    void close();
+
+    PostgreSQLConnection* conn_;
+    std::string cursorName_;
+    int fetchSize_;
+    std::unique_ptr<PostgreSQLResultSet> page_;
+    std::shared_ptr<const ResultMetadata> metadata_;   // from the first page, shared by the rest
+    bool declared_;
+    bool exhausted_;
+    bool ownsTransaction_;
 };
 
 /**
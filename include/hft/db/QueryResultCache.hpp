@@ -5,6 +5,8 @@
 #include <mutex>
 #include <chrono>
 #include <any>
+#include <vector>
+#include <algorithm>
 
 // Simple query result cache with TTL
 class QueryResultCache {
@@ -18,6 +20,7 @@ public:
     struct CacheEntry {
         std::any data;
         std::chrono::steady_clock::time_point expiresAt;
+        std::vector<std::string> tables;  // invalidated when any of these change
         
         bool isExpired() const {
             return std::chrono::steady_clock::now() >= expiresAt;
@@ -36,6 +39,35 @@ public:
         _cache[key] = entry;
     }
 
+    // Put a result that depends on tables; invalidateTable() drops it early,
+    // so it can be cached with a long TTL
+    void put(const std::string& key, const std::any& data,
+             std::chrono::seconds ttl, std::vector<std::string> tables) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        
+        CacheEntry entry;
+        entry.data = data;
+        entry.expiresAt = std::chrono::steady_clock::now() + ttl;
+        entry.tables = std::move(tables);
+        
+        _cache[key] = entry;
+    }
+
+    // Remove every entry tagged with table (e.g. on a change notification)
+    void invalidateTable(const std::string& table) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        
+        auto it = _cache.begin();
+        while (it != _cache.end()) {
+            const auto& tables = it->second.tables;
+            if (std::find(tables.begin(), tables.end(), table) != tables.end()) {
+                it = _cache.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
     // Get a result from the cache
     std::any get(const std::string& key) {
         std::lock_guard<std::mutex> lock(_mutex);
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace hft {
+namespace db {
+
+/**
+ * @brief Description of one result column
+ */
+struct ColumnInfo {
+    std::string name;
+    uint32_t typeOid = 0;   ///< Driver type code (PostgreSQL OID, DB-Lib type)
+    int typeModifier = -1;  ///< Type modifier / declared length, -1 if none
+};
+
+/**
+ * @brief Column metadata of a result, computed once and shared
+ *
+ * Holds the column descriptions and a hash index from column name to
+ * position, so name-based access costs one lookup instead of a scan over
+ * freshly allocated column names. Instances are immutable and handed out
+ * as std::shared_ptr<const ResultMetadata>, letting every execution of a
+ * statement (or every page of a cursor) reuse the same object.
+ */
+class ResultMetadata {
+public:
+    explicit ResultMetadata(std::vector<ColumnInfo> columns);
+
+    // The index holds views into columns_
+    ResultMetadata(const ResultMetadata&) = delete;
+    ResultMetadata& operator=(const ResultMetadata&) = delete;
+
+    int getColumnCount() const { return static_cast<int>(columns_.size()); }
+    const ColumnInfo& getColumn(int index) const { return columns_[index]; }
+    const std::vector<ColumnInfo>& getColumns() const { return columns_; }
+
+    /**
+     * @brief Position of the named column
+     * @return 0-based index, or -1 if no column has that name
+     * @note With duplicate names the first column wins, as in SQL
+     */
+    int findColumn(std::string_view name) const;
+
+private:
+    std::vector<ColumnInfo> columns_;
+    std::unordered_map<std::string_view, int> index_;
+};
+
+} // namespace db
+} // namespace hft
@@ -77,6 +77,12 @@ public:
     SybaseResultSet(DBPROCESS* dbproc);
     ~SybaseResultSet() override;
 
+    using IResultSet::getInt;
+    using IResultSet::getLong;
+    using IResultSet::getDouble;
+    using IResultSet::getString;
+    using IResultSet::isNull;
+
     bool next() override;
     int32_t getInt(int index) const override;
     int64_t getLong(int index) const override;
@@ -85,11 +91,14 @@ public:
     bool isNull(int index) const override;
     int getColumnCount() const override;
     std::string getColumnName(int index) const override;
+    std::shared_ptr<const ResultMetadata> getMetadata() const override;
+    int findColumn(std::string_view name) const override;
 
 private:
     DBPROCESS* dbproc_;
     int columnCount_;
     bool hasRows_;
+    std::shared_ptr<const ResultMetadata> metadata_;
 };
 
 /**
@@ -3,11 +3,16 @@
 #include "hft/db/IConnection.h"
 #include "hft/db/IStatement.h"
 #include "hft/db/IResultSet.h"
+#include "hft/db/ITransaction.h"
 #include "hft/reflection/EntityTraits.h"
 #include <memory>
 #include <vector>
 #include <optional>
 #include <sstream>
+#include <unordered_map>
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
 
 namespace hft {
 namespace orm {
@@ -38,6 +43,77 @@ public:
         return mapResultToEntity(result);
     }
     
+    /**
+     * @brief Find many entities by ID in as few round trips as possible
+     *
+     * Where the connection supports array parameters this is one
+     * "id = ANY($1::int8[])" query; otherwise IN ($1, ..) lists of up to
+     * IN_LIST_CHUNK IDs each. Duplicate IDs are queried once.
+     * @return One entry per input ID, in input order; std::nullopt where
+     *         no row matched
+     */
+    std::vector<std::optional<T>> findByIds(const std::vector<int64_t>& ids) {
+        std::vector<int64_t> keys(ids);
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        
+        std::unordered_map<int64_t, T> found;
+        found.reserve(keys.size());
+        auto collect = [&](const std::shared_ptr<db::IStatement>& stmt) {
+            auto result = stmt ? stmt->executeQuery() : nullptr;
+            if (!result) {
+                return;
+            }
+            while (result->next()) {
+                T entity{};
+                mapResultInto(*result, entity);
+                int64_t key = primaryKeyOf(entity);
+                found.emplace(key, std::move(entity));
+            }
+        };
+        
+        if (keys.empty()) {
+            // nothing to look up
+        } else if (connection_->supportsArrayParameters()) {
+            std::string literal = "{";
+            for (size_t i = 0; i < keys.size(); ++i) {
+                if (i > 0) literal += ',';
+                literal += std::to_string(keys[i]);
+            }
+            literal += '}';
+            
+            auto stmt = connection_->createStatement("SELECT * FROM " + std::string(reflection::EntityTraits<T>::tableName()) +
+                                                     " WHERE id = ANY($1::int8[])");
+            if (stmt) {
+                stmt->bindString(1, literal);
+            }
+            collect(stmt);
+        } else {
+            for (size_t offset = 0; offset < keys.size(); offset += IN_LIST_CHUNK) {
+                size_t count = std::min(IN_LIST_CHUNK, keys.size() - offset);
+                auto stmt = connection_->createStatement(inListSql(count));
+                if (stmt) {
+                    for (size_t i = 0; i < count; ++i) {
+                        stmt->bindLong(static_cast<int>(i + 1), keys[offset + i]);
+                    }
+                }
+                collect(stmt);
+            }
+        }
+        
+        std::vector<std::optional<T>> entities;
+        entities.reserve(ids.size());
+        for (int64_t id : ids) {
+            auto it = found.find(id);
+            if (it == found.end()) {
+                entities.emplace_back(std::nullopt);
+            } else {
+                entities.emplace_back(it->second);
+            }
+        }
+        return entities;
+    }
+    
     /**
      * @brief Find all entities
      */
@@ -57,6 +133,85 @@ public:
         return entities;
     }
     
+    /**
+     * @brief Lazy, single-pass range over all entities
+     *
+     * Rows are read through IConnection::openCursor(), fetchSize at a time,
+     * and mapped one by one into a single entity owned by the stream; the
+     * reference the iterator yields is overwritten when it advances.
+     * Destroying the stream (or cancel()) releases the result set, which
+     * closes the cursor so no further pages are fetched; leaving a
+     * range-for early releases nothing while the stream is alive.
+     */
+    class EntityStream {
+    public:
+        class Iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = const T&;
+
+            Iterator() : stream_(nullptr) {}
+            explicit Iterator(EntityStream* stream) : stream_(stream) {}
+
+            reference operator*() const { return stream_->entity_; }
+            pointer operator->() const { return &stream_->entity_; }
+            Iterator& operator++() {
+                if (!stream_->advance()) stream_ = nullptr;
+                return *this;
+            }
+            bool operator==(const Iterator& other) const { return stream_ == other.stream_; }
+            bool operator!=(const Iterator& other) const { return stream_ != other.stream_; }
+
+        private:
+            EntityStream* stream_;
+        };
+
+        EntityStream(Repository& repo, std::shared_ptr<db::IResultSet> result)
+            : repo_(repo), result_(std::move(result)) {}
+
+        EntityStream(const EntityStream&) = delete;
+        EntityStream& operator=(const EntityStream&) = delete;
+
+        /**
+         * @brief Reads the first row; the stream can be iterated once
+         */
+        Iterator begin() { return advance() ? Iterator(this) : Iterator(); }
+        Iterator end() { return Iterator(); }
+
+        /**
+         * @brief Stop reading and release the result set
+         */
+        void cancel() { result_.reset(); }
+
+    private:
+        bool advance() {
+            if (!result_ || !result_->next()) {
+                return false;
+            }
+            entity_ = T{};
+            repo_.mapResultInto(*result_, entity_);
+            return true;
+        }
+
+        Repository& repo_;
+        std::shared_ptr<db::IResultSet> result_;
+        T entity_{};
+    };
+
+    /**
+     * @brief Stream all entities without materialising them
+     * @param fetchSize Rows fetched per round trip
+     */
+    EntityStream stream(int fetchSize = DEFAULT_STREAM_FETCH_SIZE) {
+        std::string sql = "SELECT * FROM " + std::string(reflection::EntityTraits<T>::tableName());
+        return EntityStream(*this, connection_->openCursor(sql, fetchSize));
+    }
+
+    static constexpr int DEFAULT_STREAM_FETCH_SIZE = 1000;
+
     /**
      * @brief Insert a new entity
      */
@@ -99,6 +254,62 @@ public:
         return stmt->executeUpdate() > 0;
     }
     
+    /**
+     * @brief Insert many entities with multi-row VALUES statements
+     *
+     * Generates INSERT ... VALUES ($1..$k), ($k+1..$2k), ... with as many
+     * rows per statement as the 65535 bind-parameter limit allows and binds
+     * the whole chunk in one execution. Rows left over after the full
+     * chunks go out in power-of-two chunks, so the cache of generated SQL
+     * (and the server-side statements behind it) stays small whatever the
+     * batch sizes. Multiple chunks run inside one transaction.
+     * @return Number of rows inserted, or -1 on failure
+     */
+    int insertBatch(const std::vector<T>& entities) {
+        if (entities.empty()) {
+            return 0;
+        }
+        
+        const size_t columnCount = insertColumns().size();
+        if (columnCount == 0) {
+            return -1;
+        }
+        const size_t maxRows = MAX_BIND_PARAMETERS / columnCount;
+        
+        std::shared_ptr<db::ITransaction> txn;
+        if (batchChunk(entities.size(), maxRows) < entities.size()) {
+            txn = connection_->beginTransaction();
+        }
+        
+        int inserted = 0;
+        size_t rows = 0;
+        for (size_t offset = 0; offset < entities.size(); offset += rows) {
+            rows = batchChunk(entities.size() - offset, maxRows);
+            auto stmt = connection_->createStatement(batchInsertSql(rows));
+            if (!stmt) {
+                if (txn) txn->rollback();
+                return -1;
+            }
+            
+            int paramIndex = 1;
+            for (size_t i = offset; i < offset + rows; ++i) {
+                paramIndex = bindEntityToStatement(entities[i], stmt, true, paramIndex);
+            }
+            
+            int affected = stmt->executeUpdate();
+            if (affected < 0) {
+                if (txn) txn->rollback();
+                return -1;
+            }
+            inserted += affected;
+        }
+        
+        if (txn && !txn->commit()) {
+            return -1;
+        }
+        return inserted;
+    }
+    
     /**
      * @brief Update an existing entity
      */
@@ -161,6 +372,11 @@ public:
 private:
     std::optional<T> mapResultToEntity(std::shared_ptr<db::IResultSet> result) {
         T entity{};
+        mapResultInto(*result, entity);
+        return entity;
+    }
+    
+    void mapResultInto(db::IResultSet& result, T& entity) {
         int colIndex = 0;
         
         reflection::EntityTraits<T>::forEachField(entity, [&](const std::string& name, 
@@ -168,28 +384,26 @@ private:
                                                                auto* ptr,
                                                                bool isPK,
                                                                bool isNullable) {
-            if (!result->isNull(colIndex)) {
+            if (!result.isNull(colIndex)) {
                 using FieldType = std::remove_pointer_t<decltype(ptr)>;
                 
                 if constexpr (std::is_same_v<FieldType, int32_t> || std::is_same_v<FieldType, int>) {
-                    *ptr = result->getInt(colIndex);
+                    *ptr = result.getInt(colIndex);
                 } else if constexpr (std::is_same_v<FieldType, int64_t> || std::is_same_v<FieldType, long> || std::is_same_v<FieldType, long long>) {
-                    *ptr = result->getLong(colIndex);
+                    *ptr = result.getLong(colIndex);
                 } else if constexpr (std::is_same_v<FieldType, double> || std::is_same_v<FieldType, float>) {
-                    *ptr = result->getDouble(colIndex);
+                    *ptr = result.getDouble(colIndex);
                 } else if constexpr (std::is_same_v<FieldType, std::string>) {
-                    *ptr = result->getString(colIndex);
+                    *ptr = result.getString(colIndex);
                 }
             }
             colIndex++;
         });
-        
-        return entity;
     }
     
-    void bindEntityToStatement(const T& entity, std::shared_ptr<db::IStatement> stmt, bool skipPK) {
-        int paramIndex = 1;
-        
+    // Binds from paramIndex onwards; returns the next free parameter index
+    int bindEntityToStatement(const T& entity, std::shared_ptr<db::IStatement> stmt, bool skipPK, int paramIndex = 1) {
+
         reflection::EntityTraits<T>::forEachField(const_cast<T&>(entity), [&](const std::string& name, 
                                                                                 reflection::FieldType type,
                                                                                 auto* ptr,
@@ -209,9 +423,106 @@ private:
                 stmt->bindString(paramIndex++, *ptr);
             }
         });
+        return paramIndex;
     }
     
+    int64_t primaryKeyOf(T& entity) {
+        int64_t key = 0;
+        reflection::EntityTraits<T>::forEachField(entity, [&](const std::string&, 
+                                                               reflection::FieldType,
+                                                               auto* ptr,
+                                                               bool isPK,
+                                                               bool) {
+            using FieldType = std::remove_pointer_t<decltype(ptr)>;
+            if constexpr (std::is_integral_v<FieldType>) {
+                if (isPK) key = static_cast<int64_t>(*ptr);
+            }
+        });
+        return key;
+    }
+    
+    // SELECT * FROM t WHERE id IN ($1, .., $count)
+    const std::string& inListSql(size_t count) {
+        auto it = inListSql_.find(count);
+        if (it != inListSql_.end()) {
+            return it->second;
+        }
+        
+        std::ostringstream sql;
+        sql << "SELECT * FROM " << reflection::EntityTraits<T>::tableName() << " WHERE id IN (";
+        for (size_t i = 1; i <= count; ++i) {
+            sql << (i == 1 ? "$" : ", $") << i;
+        }
+        sql << ")";
+        return inListSql_.emplace(count, sql.str()).first->second;
+    }
+    
+    const std::vector<std::string>& insertColumns() {
+        if (insertColumns_.empty()) {
+            T entity{};
+            reflection::EntityTraits<T>::forEachField(entity, [&](const std::string& name, 
+                                                                   reflection::FieldType,
+                                                                   auto*,
+                                                                   bool isPK,
+                                                                   bool) {
+                if (!isPK) {
+                    insertColumns_.push_back(name);
+                }
+            });
+        }
+        return insertColumns_;
+    }
+    
+    // maxRows, or the largest power of two that fits in what is left
+    static size_t batchChunk(size_t remaining, size_t maxRows) {
+        if (remaining >= maxRows) {
+            return maxRows;
+        }
+        size_t rows = 1;
+        while (rows * 2 <= remaining) {
+            rows *= 2;
+        }
+        return rows;
+    }
+    
+    const std::string& batchInsertSql(size_t rows) {
+        auto it = batchInsertSql_.find(rows);
+        if (it != batchInsertSql_.end()) {
+            return it->second;
+        }
+        
+        const auto& columns = insertColumns();
+        std::ostringstream sql;
+        sql << "INSERT INTO " << reflection::EntityTraits<T>::tableName() << " (";
+        for (size_t i = 0; i < columns.size(); ++i) {
+            sql << columns[i];
+            if (i < columns.size() - 1) sql << ", ";
+        }
+        sql << ") VALUES ";
+        
+        int paramIndex = 1;
+        for (size_t row = 0; row < rows; ++row) {
+            sql << (row == 0 ? "(" : ", (");
+            for (size_t i = 0; i < columns.size(); ++i) {
+                sql << "$" << paramIndex++;
+                if (i < columns.size() - 1) sql << ", ";
+            }
+            sql << ")";
+        }
+        
+        return batchInsertSql_.emplace(rows, sql.str()).first->second;
+    }
+    
+    // PostgreSQL wire protocol limit on parameters per statement
+    static constexpr size_t MAX_BIND_PARAMETERS = 65535;
+    // IDs per IN (...) list where arrays cannot be bound
+    static constexpr size_t IN_LIST_CHUNK = 250;
+    
+
     std::shared_ptr<db::IConnection> connection_;
+    std::vector<std::string> insertColumns_;
+    std::unordered_map<size_t, std::string> batchInsertSql_;   // rows per chunk -> INSERT text
+    std::unordered_map<size_t, std::string> inListSql_;        // IDs per list -> SELECT text
 };
 
 } // namespace orm
@@ -0,0 +1,261 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+
+// Built-in PostgreSQL type OIDs (see src/include/catalog/pg_type.dat).
+// Kept here so callers do not need the server headers.
+namespace PgOid {
+    constexpr unsigned int Bool        = 16;
+    constexpr unsigned int Bytea       = 17;
+    constexpr unsigned int Int8        = 20;
+    constexpr unsigned int Int2        = 21;
+    constexpr unsigned int Int4        = 23;
+    constexpr unsigned int Text        = 25;
+    constexpr unsigned int Float4      = 700;
+    constexpr unsigned int Float8      = 701;
+    constexpr unsigned int BpChar      = 1042;
+    constexpr unsigned int VarChar     = 1043;
+    constexpr unsigned int Date        = 1082;
+    constexpr unsigned int Timestamp   = 1114;
+    constexpr unsigned int TimestampTz = 1184;
+    constexpr unsigned int Numeric     = 1700;
+}
+
+// Encoding/decoding helpers for the PostgreSQL binary wire format. All multi-byte
+// values are big-endian (network byte order).
+namespace PgBinary {
+
+// Microseconds between the Unix epoch and the PostgreSQL epoch (2000-01-01)
+constexpr std::int64_t POSTGRES_EPOCH_USEC = 946684800000000LL;
+constexpr std::int32_t POSTGRES_EPOCH_DAYS = 10957;
+
+inline std::uint16_t readUInt16(const char* p) {
+    const auto* b = reinterpret_cast<const unsigned char*>(p);
+    return static_cast<std::uint16_t>((b[0] << 8) | b[1]);
+}
+
+inline std::int16_t readInt16(const char* p) {
+    return static_cast<std::int16_t>(readUInt16(p));
+}
+
+inline std::uint32_t readUInt32(const char* p) {
+    const auto* b = reinterpret_cast<const unsigned char*>(p);
+    return (static_cast<std::uint32_t>(b[0]) << 24) |
+           (static_cast<std::uint32_t>(b[1]) << 16) |
+           (static_cast<std::uint32_t>(b[2]) << 8) |
+            static_cast<std::uint32_t>(b[3]);
+}
+
+inline std::int32_t readInt32(const char* p) {
+    return static_cast<std::int32_t>(readUInt32(p));
+}
+
+inline std::int64_t readInt64(const char* p) {
+    std::uint64_t hi = readUInt32(p);
+    std::uint64_t lo = readUInt32(p + 4);
+    return static_cast<std::int64_t>((hi << 32) | lo);
+}
+
+inline float readFloat4(const char* p) {
+    std::uint32_t bits = readUInt32(p);
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+inline double readFloat8(const char* p) {
+    std::uint64_t bits = static_cast<std::uint64_t>(readInt64(p));
+    double d;
+    std::memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+// numeric: int16 ndigits, int16 weight, uint16 sign, int16 dscale,
+// followed by ndigits base-10000 digits
+constexpr std::uint16_t NUMERIC_NEG = 0x4000;
+constexpr std::uint16_t NUMERIC_NAN = 0xC000;
+
+inline double readNumeric(const char* p, int len) {
+    if (len < 8) return 0.0;
+    int ndigits = readInt16(p);
+    int weight = readInt16(p + 2);
+    std::uint16_t sign = readUInt16(p + 4);
+    if (sign == NUMERIC_NAN) return std::numeric_limits<double>::quiet_NaN();
+
+    double value = 0.0;
+    double scale = 1.0;
+    for (int w = 0; w < weight; ++w) scale *= 10000.0;
+    for (int w = 0; w > weight; --w) scale /= 10000.0;
+    for (int i = 0; i < ndigits && 8 + 2 * i + 2 <= len; ++i) {
+        value += readInt16(p + 8 + 2 * i) * scale;
+        scale /= 10000.0;
+    }
+    return sign == NUMERIC_NEG ? -value : value;
+}
+
+inline std::string numericToString(const char* p, int len) {
+    if (len < 8) return "0";
+    int ndigits = readInt16(p);
+    int weight = readInt16(p + 2);
+    std::uint16_t sign = readUInt16(p + 4);
+    int dscale = readInt16(p + 6);
+    if (sign == NUMERIC_NAN) return "NaN";
+
+    auto digit = [&](int i) -> int {
+        return (i >= 0 && i < ndigits && 8 + 2 * i + 2 <= len) ? readInt16(p + 8 + 2 * i) : 0;
+    };
+
+    std::string out;
+    if (sign == NUMERIC_NEG) out += '-';
+
+    // Integer part: base-10000 groups 0..weight
+    if (weight < 0) {
+        out += '0';
+    } else {
+        for (int i = 0; i <= weight; ++i) {
+            std::string group = std::to_string(digit(i));
+            if (i > 0) out.append(4 - group.size(), '0');
+            out += group;
+        }
+    }
+
+    // Fraction part: dscale decimal digits
+    if (dscale > 0) {
+        out += '.';
+        int written = 0;
+        for (int i = weight + 1; written < dscale; ++i) {
+            std::string group = std::to_string(digit(i));
+            group.insert(0, 4 - group.size(), '0');
+            for (char c : group) {
+                if (written++ >= dscale) break;
+                out += c;
+            }
+        }
+    }
+    return out;
+}
+
+inline void writeInt16(char* p, std::int16_t v) {
+    auto u = static_cast<std::uint16_t>(v);
+    p[0] = static_cast<char>(u >> 8);
+    p[1] = static_cast<char>(u & 0xFF);
+}
+
+inline void writeInt32(char* p, std::int32_t v) {
+    auto u = static_cast<std::uint32_t>(v);
+    p[0] = static_cast<char>(u >> 24);
+    p[1] = static_cast<char>(u >> 16);
+    p[2] = static_cast<char>(u >> 8);
+    p[3] = static_cast<char>(u);
+}
+
+inline void writeInt64(char* p, std::int64_t v) {
+    auto u = static_cast<std::uint64_t>(v);
+    writeInt32(p, static_cast<std::int32_t>(u >> 32));
+    writeInt32(p + 4, static_cast<std::int32_t>(u & 0xFFFFFFFFu));
+}
+
+inline void writeFloat8(char* p, double v) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    writeInt64(p, static_cast<std::int64_t>(bits));
+}
+
+inline void appendInt16(std::string& out, std::int16_t v) {
+    char b[2];
+    writeInt16(b, v);
+    out.append(b, 2);
+}
+
+inline void appendInt32(std::string& out, std::int32_t v) {
+    char b[4];
+    writeInt32(b, v);
+    out.append(b, 4);
+}
+
+inline void appendInt64(std::string& out, std::int64_t v) {
+    char b[8];
+    writeInt64(b, v);
+    out.append(b, 8);
+}
+
+inline void appendFloat8(std::string& out, double v) {
+    char b[8];
+    writeFloat8(b, v);
+    out.append(b, 8);
+}
+
+// One-dimensional array without NULLs (array_recv layout). The header is
+// followed by count elements, each a 4-byte length and the element bytes.
+inline void appendArrayHeader(std::string& out, std::uint32_t elemOid, std::int32_t count) {
+    appendInt32(out, 1);                                // ndim
+    appendInt32(out, 0);                                // has nulls
+    appendInt32(out, static_cast<std::int32_t>(elemOid));
+    appendInt32(out, count);                            // dimension length
+    appendInt32(out, 1);                                // lower bound
+}
+
+// Days since 1970-01-01 to civil date (proleptic Gregorian)
+inline void civilFromDays(std::int64_t z, int& y, unsigned& m, unsigned& d) {
+    z += 719468;
+    const std::int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = static_cast<int>(yoe + era * 400 + (m <= 2));
+}
+
+// Civil date to days since 1970-01-01 (proleptic Gregorian)
+inline std::int64_t daysFromCivil(int y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const std::int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+inline std::string dateToString(std::int32_t pgDays) {
+    int y; unsigned m, d;
+    civilFromDays(static_cast<std::int64_t>(pgDays) + POSTGRES_EPOCH_DAYS, y, m, d);
+    char buf[16];
+    std::snprintf(buf, sizeof(buf), "%04d-%02u-%02u", y, m, d);
+    return buf;
+}
+
+// timestamp: int64 microseconds since 2000-01-01 00:00:00
+inline std::string timestampToString(std::int64_t pgMicros) {
+    if (pgMicros == std::numeric_limits<std::int64_t>::max()) return "infinity";
+    if (pgMicros == std::numeric_limits<std::int64_t>::min()) return "-infinity";
+
+    std::int64_t unixMicros = pgMicros + POSTGRES_EPOCH_USEC;
+    std::int64_t days = unixMicros / 86400000000LL;
+    std::int64_t rem = unixMicros % 86400000000LL;
+    if (rem < 0) { rem += 86400000000LL; --days; }
+
+    int y; unsigned m, d;
+    civilFromDays(days, y, m, d);
+    int secs = static_cast<int>(rem / 1000000);
+    int usec = static_cast<int>(rem % 1000000);
+
+    char buf[48];
+    int n = std::snprintf(buf, sizeof(buf), "%04d-%02u-%02u %02d:%02d:%02d",
+                          y, m, d, secs / 3600, (secs / 60) % 60, secs % 60);
+    if (usec != 0) {
+        // Same as the server's text output: trailing zeros trimmed
+        char frac[8];
+        std::snprintf(frac, sizeof(frac), "%06d", usec);
+        int fl = 6;
+        while (fl > 0 && frac[fl - 1] == '0') --fl;
+        std::snprintf(buf + n, sizeof(buf) - n, ".%.*s", fl, frac);
+    }
+    return buf;
+}
+
+} // namespace PgBinary
@@ -1,12 +1,17 @@
 #pragma once
 #include "db/IDBConnection.hpp"
+#include <cstddef>
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 // Forward declare libpq type
 struct pg_conn;
 typedef struct pg_conn PGconn;
 
+class PgPipeline;
+class PgNotificationListener;
+
 class PgConnection : public IDBConnection {
 public:
     explicit PgConnection(const std::string& conninfo);
@@ -15,16 +20,89 @@ public:
     std::unique_ptr<IDBReader>
     executeQuery(const std::string& sql) override;
 
+    // SingleRow streams rows through PgStreamingReader; fetchSize > 1
+    // selects chunked-rows mode when libpq supports it (17+). Cursor pages
+    // through a server-side cursor with PgCursorReader.
+    std::unique_ptr<IDBReader>
+    executeStreamingQuery(const std::string& sql, FetchMode mode, int fetchSize) override;
+
+    // Runs COPY (query) TO STDOUT (FORMAT binary); rows are decoded as
+    // they arrive by PgCopyOutReader. Fastest path for bulk extraction.
+    std::unique_ptr<IDBReader>
+    executeCopyOut(const std::string& query);
+
     std::unique_ptr<IDBPreparedStatement>
     prepare(const std::string& sql) override;
 
     std::unique_ptr<IDBTransaction>
     beginTransaction() override;
 
+    // Enters libpq pipeline mode; see PgPipeline
+    std::unique_ptr<IDBPipeline>
+    beginPipeline() override;
+
+    // int4[]/float8[]/text[] binds go out as binary arrays
+    bool supportsArrayParameters() const override { return true; }
+
+    // COPY ... FROM STDIN (FORMAT binary); see PgCopyWriter
+    std::unique_ptr<IDBBulkWriter>
+    beginBulkInsert(const std::string& table, const std::vector<std::string>& columns) override;
+
+    // Bytes PgCopyWriter buffers before each PQputCopyData call
+    void setCopyBufferSize(std::size_t bytes) { _copyBufferSize = bytes; }
+    std::size_t copyBufferSize() const { return _copyBufferSize; }
+
+    // LISTEN/NOTIFY subscriber on a new, dedicated connection to the same
+    // server (a connection that runs queries cannot wait on notifications)
+    std::unique_ptr<PgNotificationListener> createNotificationListener();
+
+    // Unique name for a server-side cursor on this connection
+    std::string nextCursorName() { return "hft_cursor_" + std::to_string(++_cursorCounter); }
+
+    // Pipeline currently open on this connection, if any
+    PgPipeline* activePipeline() { return _pipeline; }
+
     // Access to underlying connection
     PGconn* getConnection() { return _conn; }
 
+    // Request binary results (resultFormat = 1) for executeQuery and for
+    // statements prepared afterwards; PgValue then decodes cells directly
+    void setBinaryResults(bool enabled) { _binaryResults = enabled; }
+    bool binaryResults() const { return _binaryResults; }
+
+    // Run statements through PQprepare/PQexecPrepared instead of
+    // PQexecParams, so the server parses and plans each SQL text once.
+    // Applies to statements prepared afterwards.
+    void setServerPrepare(bool enabled) { _serverPrepare = enabled; }
+    bool serverPrepare() const { return _serverPrepare; }
+
+    // Name of the server-side statement for sql, issuing PQprepare the
+    // first time this SQL text is seen on the connection
+    const std::string& preparedStatementName(const std::string& sql);
+    std::size_t preparedStatementCount() const { return _preparedStatements.size(); }
+
+    // Registry access for callers that prepare asynchronously (pipelines):
+    // find an existing name, reserve a name to PQsendPrepare under, or drop
+    // a reservation whose prepare failed
+    const std::string* findPreparedStatement(const std::string& sql) const;
+    const std::string& reservePreparedStatement(const std::string& sql);
+    void forgetPreparedStatement(const std::string& sql);
+
 private:
+    // Synchronous calls (PQexec, COPY, BEGIN) are not allowed in pipeline mode
+    void requireNoPipeline(const char* caller) const;
+
     std::string _conninfo;
     PGconn* _conn{nullptr};
+    bool _binaryResults{false};
+    bool _serverPrepare{false};
+    std::size_t _copyBufferSize{256 * 1024};
+
+    // SQL text -> server-side statement name
+    std::unordered_map<std::string, std::string> _preparedStatements;
+    unsigned long _preparedCounter{0};
+    unsigned long _cursorCounter{0};
+
+    PgPipeline* _pipeline{nullptr};
+    friend class PgPipeline;
 };
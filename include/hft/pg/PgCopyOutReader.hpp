@@ -0,0 +1,58 @@
+#pragma once
+#include "db/IDBReader.hpp"
+#include "db/IDBRow.hpp"
+#include "pg/PgValue.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class PgConnection;
+
+// Row decoded from a binary COPY stream. The reader owns a single
+// instance; its cells view the reader's buffer and are re-pointed on
+// every next().
+class PgCopyOutRow : public IDBRow {
+public:
+    std::size_t columnCount() const override { return _values.size(); }
+    const IDBValue& operator[](std::size_t idx) const override;
+
+private:
+    friend class PgCopyOutReader;
+    std::vector<PgValue> _values;
+};
+
+// Reader over COPY (query) TO STDOUT (FORMAT binary). Rows are pulled with
+// PQgetCopyData and decoded into a reused buffer and row, so memory use
+// does not grow with the result size. Column types come from describing
+// the query first, which lets PgValue decode the binary cells.
+//
+// The connection is busy until the reader is exhausted or destroyed;
+// destroying it early cancels the COPY.
+class PgCopyOutReader : public IDBReader {
+public:
+    PgCopyOutReader(PgConnection* conn, const std::string& query);
+    ~PgCopyOutReader() override;
+
+    bool next() override;
+    IDBRow& row() override;
+
+    // Ask the server to stop sending rows and discard what is in flight
+    void cancel();
+
+private:
+    void describe(const std::string& query);
+    bool fill();
+    bool parseHeader();
+    bool parseRow(bool& trailer);
+    void finishCopy();
+    void drain();
+
+    PgConnection* _conn{nullptr};
+    std::string _buffer;
+    std::size_t _offset{0};
+    bool _headerRead{false};
+    bool _streamEnded{false};
+    bool _done{false};
+    bool _hasRow{false};
+    PgCopyOutRow _row;
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include "db/IDBBulkWriter.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class PgConnection;
+
+// COPY table (columns) FROM STDIN (FORMAT binary). Rows are encoded into
+// a local buffer and handed to PQputCopyData whenever it exceeds
+// bufferSize bytes.
+//
+// Binary COPY does not coerce types: writeInt() must target an integer
+// column, writeDouble() a double precision column, and writeString() a
+// text/varchar column.
+class PgCopyWriter : public IDBBulkWriter {
+public:
+    static constexpr std::size_t DEFAULT_BUFFER_SIZE = 256 * 1024;
+
+    PgCopyWriter(PgConnection* conn, const std::string& table,
+                 const std::vector<std::string>& columns,
+                 std::size_t bufferSize = DEFAULT_BUFFER_SIZE);
+    ~PgCopyWriter() override;
+
+    void startRow() override;
+    void writeNull() override;
+    void writeInt(int value) override;
+    void writeDouble(double value) override;
+    void writeString(const std::string& value) override;
+
+    long finish() override;
+
+    void setBufferSize(std::size_t bytes) { _bufferSize = bytes ? bytes : 1; }
+
+private:
+    void beginField();
+    void flush();
+    void abort(const char* reason);
+
+    PgConnection* _conn{nullptr};
+    std::string _buffer;
+    std::size_t _bufferSize{DEFAULT_BUFFER_SIZE};
+    int _columnCount{0};
+    int _fieldsInRow{0};
+    bool _inRow{false};
+    bool _active{false};
+};
@@ -0,0 +1,43 @@
+#pragma once
+#include "db/IDBReader.hpp"
+#include "pg/PgRow.hpp"
+#include <string>
+
+// Forward declare libpq type
+struct pg_result;
+typedef struct pg_result PGresult;
+
+class PgConnection;
+
+// Reader over DECLARE ... NO SCROLL CURSOR FOR sql. The buffer is refilled
+// with FETCH FORWARD fetchSize as next() advances, so at most one page is
+// held client-side and the connection stays free between fetches. Cursors
+// need a transaction: if none is open, the reader begins one and commits
+// it when closed or destroyed.
+class PgCursorReader : public IDBReader {
+public:
+    PgCursorReader(PgConnection* conn, const std::string& sql, int fetchSize);
+    ~PgCursorReader() override;
+
+    bool next() override;
+    IDBRow& row() override;
+
+    // Close the cursor (and the transaction the reader opened, if any)
+    void close();
+
+private:
+    void fetch();
+    void exec(const std::string& sql);
+
+    PgConnection* _conn{nullptr};
+    std::string _cursorName;
+    std::string _fetchSql;
+    PGresult* _result{nullptr};
+    int _currentRow{-1};
+    int _numRows{0};
+    int _fetchSize{1};
+    bool _declared{false};
+    bool _exhausted{false};
+    bool _ownsTransaction{false};
+    PgRow _row;  // rebound to each fetched page
+};
@@ -0,0 +1,71 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class PgConnection;
+
+// LISTEN/NOTIFY change feed on a dedicated connection. poll() never
+// blocks: it reads whatever the socket has buffered (PQconsumeInput) and
+// dispatches each PQnotifies entry. Call it from a timer, or when
+// socket() becomes readable.
+//
+// Table invalidation uses one channel (INVALIDATION_CHANNEL by default).
+// The triggers from invalidationTriggerSql() NOTIFY it with the table
+// name as payload, and onInvalidate() callbacks are keyed by that name.
+// The key is the unqualified name as the server stores it, so unquoted
+// identifiers are lower case.
+class PgNotificationListener {
+public:
+    static constexpr const char* INVALIDATION_CHANNEL = "hft_invalidate";
+
+    // channel, payload
+    using NotifyCallback = std::function<void(const std::string&, const std::string&)>;
+    // table name
+    using InvalidateCallback = std::function<void(const std::string&)>;
+
+    explicit PgNotificationListener(std::unique_ptr<PgConnection> conn,
+                                    const std::string& invalidationChannel = INVALIDATION_CHANNEL);
+    ~PgNotificationListener();
+
+    void listen(const std::string& channel);
+    void unlisten(const std::string& channel);
+
+    // Raw notifications on channel
+    void onNotify(const std::string& channel, NotifyCallback callback);
+    // Changes to table (LISTENs on the invalidation channel on first use)
+    void onInvalidate(const std::string& table, InvalidateCallback callback);
+    // Drop QueryResultCache entries tagged with table whenever it changes
+    void invalidateQueryCache(const std::string& table);
+
+    // Dispatch pending notifications; returns how many were received
+    int poll();
+
+    // Descriptor to wait on for readability, or -1
+    int socket() const;
+
+    // Install the NOTIFY trigger for table through the listener's connection
+    void installInvalidationTrigger(const std::string& table);
+
+    // Statement-level AFTER INSERT/UPDATE/DELETE/TRUNCATE trigger that
+    // NOTIFYs channel with the table name as payload
+    static std::string invalidationTriggerSql(const std::string& table,
+                                              const std::string& channel = INVALIDATION_CHANNEL);
+
+    PgConnection& connection() { return *_conn; }
+
+private:
+    void execute(const std::string& sql);
+    std::string quoteIdentifier(const std::string& name);
+
+    std::unique_ptr<PgConnection> _conn;
+    std::string _invalidationChannel;
+    bool _listeningForInvalidation{false};
+
+    std::mutex _mutex;
+    std::unordered_map<std::string, std::vector<NotifyCallback>> _channelCallbacks;
+    std::unordered_map<std::string, std::vector<InvalidateCallback>> _tableCallbacks;
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include "db/IDBPipeline.hpp"
+#include <deque>
+#include <string>
+#include <vector>
+
+class PgConnection;
+
+// libpq pipeline mode (PQenterPipelineMode / PQpipelineSync). Executions
+// are sent without waiting for their results; results are read back at
+// each sync point. The connection may not run synchronous calls (PQexec,
+// PQprepare, transactions) while the pipeline is open.
+//
+// The connection stays in blocking mode, so the queue is synced
+// automatically every maxPending statements to keep the unread results
+// within the socket buffers.
+class PgPipeline : public IDBPipeline {
+public:
+    explicit PgPipeline(PgConnection* conn, std::size_t maxPending = 512);
+    ~PgPipeline() override;
+
+    std::size_t pending() const override;
+    std::vector<DBPipelineResult> sync() override;
+
+    // Queue one execution of sql. params are text unless formats marks them
+    // binary (1); empty formats means all text. With serverPrepare the
+    // connection's named statement is used, preparing it inside the pipeline
+    // on first use.
+    void enqueue(const std::string& sql, const std::vector<std::string>& params, bool serverPrepare,
+                 const std::vector<int>& formats = {});
+
+    void setMaxPending(std::size_t maxPending) { _maxPending = maxPending ? maxPending : 1; }
+
+private:
+    // Commands in flight, in send order. Prepares are tracked so a failed
+    // PQsendPrepare can be dropped from the connection registry, but they
+    // produce no DBPipelineResult.
+    struct Pending {
+        bool isPrepare{false};
+        std::string sql;
+    };
+
+    void collect();
+
+    PgConnection* _conn{nullptr};
+    std::size_t _maxPending{512};
+    std::size_t _queued{0};
+    std::deque<Pending> _inFlight;
+    std::vector<DBPipelineResult> _results;
+};
@@ -5,6 +5,7 @@
 
 // Forward declarations
 class PgConnection;
+struct pg_result;
 
 class PgPreparedStatement : public IDBPreparedStatement {
 public:
@@ -15,11 +16,41 @@ public:
     void bindDouble(int index, double value) override;
     void bindString(int index, const std::string& value) override;
 
+    // Arrays are sent in binary array format; the SQL must give the
+    // parameter a matching type ($1::int4[], $1::float8[], $1::text[])
+    void bindIntArray(int index, const std::vector<int>& values) override;
+    void bindDoubleArray(int index, const std::vector<double>& values) override;
+    void bindStringArray(int index, const std::vector<std::string>& values) override;
+
     std::unique_ptr<IDBReader> executeQuery() override;
     void executeUpdate() override;
 
+    // Streams the result through PgStreamingReader instead of buffering it
+    std::unique_ptr<IDBReader> executeStreamingQuery(int chunkSize = 1);
+
+    // Ask libpq for binary results (resultFormat = 1). Defaults to the
+    // connection's setting at prepare time.
+    void setBinaryResults(bool enabled) { _binaryResults = enabled; }
+
+    // Execute through the connection's named server-side statement for this
+    // SQL (PQexecPrepared). Defaults to the connection's setting.
+    void setServerPrepare(bool enabled) { _serverPrepare = enabled; }
+
 private:
     std::string _sql;
     std::vector<std::string> _params;
+    std::vector<int> _formats;   // per parameter: 0 = text, 1 = binary
+    bool _hasBinary{false};
     PgConnection* _conn{nullptr};
+    bool _binaryResults{false};
+    bool _serverPrepare{false};
+
+    // Sends the statement with the bound parameters; never returns null
+    pg_result* execute(const char* caller, int resultFormat);
+    // Same, through the asynchronous PQsend* entry points
+    void send(const char* caller, int resultFormat);
+    std::vector<const char*> paramValues() const;
+    std::vector<int> paramLengths() const;
+    // Storage for parameter index, sized on demand and marked text or binary
+    std::string& param(int index, int format, const char* caller);
 };
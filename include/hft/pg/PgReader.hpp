@@ -1,13 +1,11 @@
 #pragma once
 #include "db/IDBReader.hpp"
-#include <memory>
+#include "pg/PgRow.hpp"
 
 // Forward declare libpq type
 struct pg_result;
 typedef struct pg_result PGresult;
 
-class IDBRow;
-
 class PgReader : public IDBReader {
 public:
     explicit PgReader(PGresult* result);
@@ -20,5 +18,5 @@ private:
     PGresult* _result{nullptr};
     int _currentRow{-1};
     int _numRows{0};
-    std::unique_ptr<IDBRow> _row;
+    PgRow _row;  // re-pointed at each row by next()
 };
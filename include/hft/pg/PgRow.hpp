@@ -1,7 +1,7 @@
 #pragma once
 #include "db/IDBRow.hpp"
+#include "pg/PgValue.hpp"
 #include <vector>
-#include <memory>
 
 // Forward declare libpq type
 struct pg_result;
@@ -9,14 +9,24 @@ typedef struct pg_result PGresult;
 
 class IDBValue;
 
+// View over one row of a PGresult. Readers keep a single PgRow and move it
+// from row to row, so iterating allocates nothing: each cell is a PgValue
+// pointing at the bytes libpq already holds.
 class PgRow : public IDBRow {
 public:
-    PgRow(PGresult* result, int rowNum);
+    PgRow() = default;
     ~PgRow() override;
 
+    // Bind to result: records column types and sizes the cell views.
+    // Rebinding to a result with no more columns reuses the storage.
+    void reset(PGresult* result);
+    // Point every cell at row rowNum of the bound result
+    void setRow(int rowNum);
+
     std::size_t columnCount() const override;
     const IDBValue& operator[](std::size_t idx) const override;
 
 private:
-    std::vector<std::unique_ptr<IDBValue>> _values;
+    PGresult* _result{nullptr};
+    std::vector<PgValue> _values;
 };
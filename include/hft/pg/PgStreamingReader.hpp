@@ -0,0 +1,37 @@
+#pragma once
+#include "db/IDBReader.hpp"
+#include "pg/PgRow.hpp"
+
+// Forward declare libpq type
+struct pg_result;
+typedef struct pg_result PGresult;
+
+class PgConnection;
+
+// Reader over a query already sent with PQsend*; rows are pulled with
+// PQgetResult in single-row mode (chunked-rows mode on libpq 17+), so only
+// one row or chunk is held in client memory at a time. The connection is
+// busy until the reader is exhausted or destroyed; destroying it early
+// cancels the query.
+class PgStreamingReader : public IDBReader {
+public:
+    PgStreamingReader(PgConnection* conn, int chunkSize);
+    ~PgStreamingReader() override;
+
+    bool next() override;
+    IDBRow& row() override;
+
+    // Ask the server to stop sending rows and discard what is in flight
+    void cancel();
+
+private:
+    void drain();
+
+    PgConnection* _conn{nullptr};
+    PGresult* _result{nullptr};
+    int _currentRow{-1};
+    int _numRows{0};
+    bool _done{false};
+    bool _hasRow{false};
+    PgRow _row;  // rebound to each single-row/chunk result
+};
@@ -1,18 +1,47 @@
 #pragma once
 #include "db/IDBValue.hpp"
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
 
+// Non-owning view over one cell. The bytes belong to the PGresult or COPY
+// buffer the value was taken from and stay valid until the owning reader
+// moves to the next row.
 class PgValue : public IDBValue {
 public:
-    PgValue();
-    PgValue(std::string v, bool isNull);
+    PgValue() = default;
+    // typeOid comes from PQftype; binary cells hold the raw network-order bytes
+    PgValue(std::string_view v, bool isNull, unsigned int typeOid = 0, bool binary = false);
 
     bool isNull() const override;
     int asInt() const override;
     double asDouble() const override;
     std::string asString() const override;
 
+    // Typed getters. Binary cells are decoded straight from network byte
+    // order using the column OID; text cells fall back to parsing.
+    std::int64_t asInt64() const;
+    bool asBool() const;
+    // Microseconds since the Unix epoch (timestamp/timestamptz, UTC)
+    std::int64_t asTimestamp() const;
+
+    // Re-point the view at another cell of the same column
+    void assign(const char* data, std::size_t len, bool isNull) {
+        _value = isNull ? std::string_view() : std::string_view(data, len);
+        _null = isNull;
+    }
+    void setType(unsigned int typeOid, bool binary) {
+        _type = typeOid;
+        _binary = binary;
+    }
+
+    unsigned int typeOid() const { return _type; }
+    bool isBinary() const { return _binary; }
+
 private:
-    std::string _value;
+    std::string_view _value;
     bool _null{true};
+    unsigned int _type{0};
+    bool _binary{false};
 };
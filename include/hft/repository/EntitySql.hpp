@@ -0,0 +1,163 @@
+#pragma once
+#include "entity/EntityTraits.hpp"
+#include <cstddef>
+#include <string_view>
+#include <tuple>
+
+// CRUD statements for Repository<Entity>, generated at compile time from
+// EntityTraits<Entity> into fixed-size character arrays. Every value is a
+// $n placeholder, numbered in EntityTraits<Entity>::columns order with
+// the primary key skipped (and bound last in UPDATE):
+//
+//   selectAll   SELECT * FROM t
+//   selectById  SELECT * FROM t WHERE pk=$1
+//   selectByIds SELECT * FROM t WHERE pk = ANY($1::int4[])
+//   insert      INSERT INTO t (c2, c3) VALUES ($1, $2)
+//   update      UPDATE t SET c2=$1, c3=$2 WHERE pk=$3
+//   remove      DELETE FROM t WHERE pk=$1
+template<std::size_t N>
+struct FixedSql {
+    char text[N + 1]{};
+
+    constexpr std::size_t size() const { return N; }
+    constexpr std::string_view view() const { return std::string_view(text, N); }
+    const char* c_str() const { return text; }
+};
+
+namespace entity_sql {
+
+// Appends to out, or only counts when out is null, so one builder both
+// sizes and fills the array
+struct Writer {
+    char* out{nullptr};
+    std::size_t size{0};
+
+    constexpr void put(char c) {
+        if (out) out[size] = c;
+        ++size;
+    }
+    constexpr void append(std::string_view s) {
+        for (char c : s) put(c);
+    }
+    constexpr void placeholder(int index) {
+        char digits[10]{};
+        int len = 0;
+        do {
+            digits[len++] = static_cast<char>('0' + index % 10);
+            index /= 10;
+        } while (index > 0);
+        put('$');
+        while (len > 0) put(digits[--len]);
+    }
+};
+
+template<typename Entity>
+constexpr void selectAll(Writer& w) {
+    w.append("SELECT * FROM ");
+    w.append(EntityTraits<Entity>::tableName);
+}
+
+template<typename Entity>
+constexpr void selectById(Writer& w) {
+    selectAll<Entity>(w);
+    w.append(" WHERE ");
+    w.append(EntityTraits<Entity>::primaryKey);
+    w.append("=");
+    w.placeholder(1);
+}
+
+template<typename Entity>
+constexpr void selectByIds(Writer& w) {
+    selectAll<Entity>(w);
+    w.append(" WHERE ");
+    w.append(EntityTraits<Entity>::primaryKey);
+    w.append(" = ANY(");
+    w.placeholder(1);
+    w.append("::int4[])");
+}
+
+// Calls f(col) for every non-key column, in declaration order
+template<typename Entity, typename F>
+constexpr void forEachValueColumn(F&& f) {
+    std::apply([&](const auto&... col) {
+        auto visit = [&](const auto& c) {
+            if (c.name != EntityTraits<Entity>::primaryKey) f(c);
+        };
+        (visit(col), ...);
+    }, EntityTraits<Entity>::columns);
+}
+
+template<typename Entity>
+constexpr void insert(Writer& w) {
+    w.append("INSERT INTO ");
+    w.append(EntityTraits<Entity>::tableName);
+    w.append(" (");
+    bool first = true;
+    forEachValueColumn<Entity>([&](const auto& col) {
+        if (!first) w.append(", ");
+        w.append(col.name);
+        first = false;
+    });
+    w.append(") VALUES (");
+    int index = 1;
+    forEachValueColumn<Entity>([&](const auto&) {
+        if (index > 1) w.append(", ");
+        w.placeholder(index++);
+    });
+    w.append(")");
+}
+
+template<typename Entity>
+constexpr void update(Writer& w) {
+    w.append("UPDATE ");
+    w.append(EntityTraits<Entity>::tableName);
+    w.append(" SET ");
+    int index = 1;
+    forEachValueColumn<Entity>([&](const auto& col) {
+        if (index > 1) w.append(", ");
+        w.append(col.name);
+        w.put('=');
+        w.placeholder(index++);
+    });
+    w.append(" WHERE ");
+    w.append(EntityTraits<Entity>::primaryKey);
+    w.put('=');
+    w.placeholder(index);
+}
+
+template<typename Entity>
+constexpr void remove(Writer& w) {
+    w.append("DELETE FROM ");
+    w.append(EntityTraits<Entity>::tableName);
+    w.append(" WHERE ");
+    w.append(EntityTraits<Entity>::primaryKey);
+    w.put('=');
+    w.placeholder(1);
+}
+
+template<void (*Build)(Writer&)>
+constexpr std::size_t length() {
+    Writer w;
+    Build(w);
+    return w.size;
+}
+
+template<void (*Build)(Writer&)>
+constexpr FixedSql<length<Build>()> make() {
+    FixedSql<length<Build>()> sql{};
+    Writer w{sql.text};
+    Build(w);
+    return sql;
+}
+
+} // namespace entity_sql
+
+template<typename Entity>
+struct EntitySql {
+    static constexpr auto selectAll = entity_sql::make<&entity_sql::selectAll<Entity>>();
+    static constexpr auto selectById = entity_sql::make<&entity_sql::selectById<Entity>>();
+    static constexpr auto selectByIds = entity_sql::make<&entity_sql::selectByIds<Entity>>();
+    static constexpr auto insert = entity_sql::make<&entity_sql::insert<Entity>>();
+    static constexpr auto update = entity_sql::make<&entity_sql::update<Entity>>();
+    static constexpr auto remove = entity_sql::make<&entity_sql::remove<Entity>>();
+};
@@ -1,16 +1,33 @@
 #pragma once
 #include "entity/EntityTraits.hpp"
+#include "repository/EntitySql.hpp"
 #include "db/IDBConnection.hpp"
 #include "db/IDBPreparedStatement.hpp"
 #include "db/IDBReader.hpp"
 #include "db/IDBRow.hpp"
 #include "db/IDBValue.hpp"
 #include "db/IDBTransaction.hpp"
+#include "db/IDBPipeline.hpp"
+#include "db/IDBBulkWriter.hpp"
 #include "db/DBException.hpp"
 #include <vector>
 #include <string>
 #include <sstream>
 #include <type_traits>
+#include <unordered_map>
+#include <algorithm>
+#include <optional>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+// How insertBatch() sends its rows
+enum class BatchInsertMode {
+    Statements,  // one prepared INSERT round trip per entity
+    Pipeline,    // INSERTs queued on IDBConnection::beginPipeline(); falls back to Statements
+    Copy,        // rows streamed through IDBConnection::beginBulkInsert(); falls back to Statements
+    MultiRow     // INSERT ... VALUES (...),(...) chunks, one execution per chunk; works where COPY is blocked
+};
 
 template<typename Entity>
 class Repository {
@@ -18,11 +35,13 @@ public:
     explicit Repository(IDBConnection& conn)
         : _conn(conn) {}
 
+    void setBatchInsertMode(BatchInsertMode mode) { _batchInsertMode = mode; }
+    BatchInsertMode batchInsertMode() const { return _batchInsertMode; }
+
     std::vector<Entity> getAll() {
+        static const std::string sql(EntitySql<Entity>::selectAll.view());
         std::vector<Entity> result;
-        std::ostringstream oss;
-        oss << "SELECT * FROM " << EntityTraits<Entity>::tableName;
-        auto reader = _conn.executeQuery(oss.str());
+        auto reader = _conn.executeQuery(sql);
         while (reader->next()) {
             Entity e{};
             mapRowToEntity(reader->row(), e);
@@ -31,11 +50,91 @@ public:
         return result;
     }
 
+    // Same as getAll(), but rows are pulled with the given fetch strategy
+    // (FetchMode::SingleRow, or FetchMode::Cursor to page fetchSize rows
+    // through a server-side cursor) instead of buffering the whole result set
+    std::vector<Entity> getAll(FetchMode mode, int fetchSize = 0) {
+        static const std::string sql(EntitySql<Entity>::selectAll.view());
+        std::vector<Entity> result;
+        auto reader = _conn.executeStreamingQuery(sql, mode, fetchSize);
+        while (reader->next()) {
+            Entity e{};
+            mapRowToEntity(reader->row(), e);
+            result.push_back(std::move(e));
+        }
+        return result;
+    }
+
+    // Lazy range over the table for range-for loops. Rows are mapped one
+    // at a time into a single Entity owned by the stream, so the reference
+    // the iterator yields is overwritten when it advances. Destroying the
+    // stream (or cancel()) destroys the reader, which abandons the query:
+    // with FetchMode::SingleRow or Cursor the rest is never transferred.
+    // Leaving a loop early releases nothing while the stream is alive.
+    class EntityStream {
+    public:
+        class Iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = Entity;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Entity*;
+            using reference = const Entity&;
+
+            Iterator() = default;
+            explicit Iterator(EntityStream* stream) : _stream(stream) {}
+
+            reference operator*() const { return _stream->_entity; }
+            pointer operator->() const { return &_stream->_entity; }
+            Iterator& operator++() {
+                if (!_stream->advance()) _stream = nullptr;
+                return *this;
+            }
+            bool operator==(const Iterator& other) const { return _stream == other._stream; }
+            bool operator!=(const Iterator& other) const { return _stream != other._stream; }
+
+        private:
+            EntityStream* _stream{nullptr};
+        };
+
+        EntityStream(Repository& repo, std::unique_ptr<IDBReader> reader)
+            : _repo(repo), _reader(std::move(reader)) {}
+
+        EntityStream(const EntityStream&) = delete;
+        EntityStream& operator=(const EntityStream&) = delete;
+
+        // Single pass: begin() reads the first row
+        Iterator begin() { return advance() ? Iterator(this) : Iterator(); }
+        Iterator end() { return Iterator(); }
+
+        // Stop reading and release the query
+        void cancel() { _reader.reset(); }
+
+    private:
+        bool advance() {
+            if (!_reader || !_reader->next()) {
+                return false;
+            }
+            _entity = Entity{};
+            _repo.mapRowToEntity(_reader->row(), _entity);
+            return true;
+        }
+
+        Repository& _repo;
+        std::unique_ptr<IDBReader> _reader;
+        Entity _entity{};
+    };
+
+    EntityStream stream(FetchMode mode = FetchMode::SingleRow, int fetchSize = 0) {
+        static const std::string sql(EntitySql<Entity>::selectAll.view());
+        return EntityStream(*this, _conn.executeStreamingQuery(sql, mode, fetchSize));
+    }
+
     Entity getById(int id) {
-        std::ostringstream oss;
-        oss << "SELECT * FROM " << EntityTraits<Entity>::tableName
-            << " WHERE " << EntityTraits<Entity>::primaryKey << "=" << id;
-        auto reader = _conn.executeQuery(oss.str());
+        static const std::string sql(EntitySql<Entity>::selectById.view());
+        auto stmt = _conn.prepare(sql);
+        stmt->bindInt(1, id);
+        auto reader = stmt->executeQuery();
         if (!reader->next()) {
             throw DBException("Entity not found");
         }
@@ -44,107 +143,324 @@ public:
         return e;
     }
 
+    // Primary-key lookup of many ids in as few round trips as possible.
+    // The result is aligned with ids, an empty optional marking an id with
+    // no row. Duplicate ids are queried once. Where the connection supports
+    // array parameters this is one "pk = ANY($1)" query with the ids bound
+    // as an int4[]; otherwise IN ($1, ..) lists of up to IN_LIST_CHUNK ids.
+    std::vector<std::optional<Entity>> findByIds(const std::vector<int>& ids) {
+        std::vector<int> keys(ids);
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+        std::unordered_map<int, Entity> found;
+        found.reserve(keys.size());
+        auto collect = [&](IDBPreparedStatement& stmt) {
+            auto reader = stmt.executeQuery();
+            while (reader->next()) {
+                Entity e{};
+                mapRowToEntity(reader->row(), e);
+                int key = primaryKeyOf(e);
+                found.emplace(key, std::move(e));
+            }
+        };
+
+        if (keys.empty()) {
+            // nothing to look up
+        } else if (_conn.supportsArrayParameters()) {
+            static const std::string sql(EntitySql<Entity>::selectByIds.view());
+            auto stmt = _conn.prepare(sql);
+            stmt->bindIntArray(1, keys);
+            collect(*stmt);
+        } else {
+            for (std::size_t offset = 0; offset < keys.size(); offset += IN_LIST_CHUNK) {
+                std::size_t count = std::min(IN_LIST_CHUNK, keys.size() - offset);
+                auto stmt = _conn.prepare(inListSql(count));
+                for (std::size_t i = 0; i < count; ++i) {
+                    stmt->bindInt(static_cast<int>(i + 1), keys[offset + i]);
+                }
+                collect(*stmt);
+            }
+        }
+
+        std::vector<std::optional<Entity>> result;
+        result.reserve(ids.size());
+        for (int id : ids) {
+            auto it = found.find(id);
+            if (it == found.end()) {
+                result.emplace_back(std::nullopt);
+            } else {
+                result.emplace_back(it->second);
+            }
+        }
+        return result;
+    }
+
     void insert(const Entity& e) {
-        std::ostringstream oss;
-        oss << "INSERT INTO " << EntityTraits<Entity>::tableName << " (";
-        
-        // Build column list (skip primary key if auto-increment)
-        bool first = true;
+        insertPS(e);
+    }
+
+    void update(const Entity& e) {
+        static const std::string sql(EntitySql<Entity>::update.view());
+        auto stmt = _conn.prepare(sql);
+        int paramIndex = 1;
         std::apply([&](auto&&... col) {
-            ((buildColumnList(oss, col, first, true)), ...);
+            ((bindParameter(stmt.get(), col, e, paramIndex, true)), ...);
         }, EntityTraits<Entity>::columns);
-        
-        oss << ") VALUES (";
-        
-        // Build values list
-        first = true;
+        bindPrimaryKey(stmt.get(), e, paramIndex);
+        stmt->executeUpdate();
+    }
+
+    void remove(const Entity& e) {
+        static const std::string sql(EntitySql<Entity>::remove.view());
+        auto stmt = _conn.prepare(sql);
+        int paramIndex = 1;
+        bindPrimaryKey(stmt.get(), e, paramIndex);
+        stmt->executeUpdate();
+    }
+
+    void insertPS(const Entity& e) {
+        auto stmt = _conn.prepare(insertSql());
+        bindInsertParams(stmt.get(), e);
+        stmt->executeUpdate();
+    }
+
+    void insertBatch(const std::vector<Entity>& list) {
+        auto txn = _conn.beginTransaction();
+        try {
+            if (_batchInsertMode == BatchInsertMode::Copy) {
+                insertBatchCopy(list);
+            } else if (_batchInsertMode == BatchInsertMode::MultiRow) {
+                insertBatchMultiRow(list);
+            } else if (_batchInsertMode == BatchInsertMode::Pipeline) {
+                insertBatchPipelined(list);
+            } else {
+                for (const auto& entity : list) {
+                    insertPS(entity);
+                }
+            }
+            txn->commit();
+        } catch (...) {
+            txn->rollback();
+            throw;
+        }
+    }
+
+    // Insert-or-update the whole batch with one statement: entities are
+    // transposed into one array per column (primary key included) and
+    // expanded server-side by unnest(), so the SQL text, and with it the
+    // plan, is the same whatever the batch size. String fields travel as
+    // text[]. A batch must not contain the same key twice.
+    void upsertBatch(const std::vector<Entity>& list) {
+        if (list.empty()) {
+            return;
+        }
+
+        auto stmt = _conn.prepare(upsertBatchSql());
+        int paramIndex = 1;
         std::apply([&](auto&&... col) {
-            ((buildValuesList(oss, col, e, first, true)), ...);
+            ((bindColumnArray(stmt.get(), col, list, paramIndex)), ...);
         }, EntityTraits<Entity>::columns);
-        
-        oss << ")";
-        
-        _conn.executeQuery(oss.str());
+        stmt->executeUpdate();
     }
 
-    void update(const Entity& e) {
-        std::ostringstream oss;
-        oss << "UPDATE " << EntityTraits<Entity>::tableName << " SET ";
-        
-        // Build SET clause (skip primary key)
-        bool first = true;
+protected:
+    // One prepared INSERT, queued on a pipeline so the whole batch costs a
+    // few round trips instead of one per entity
+    void insertBatchPipelined(const std::vector<Entity>& list) {
+        auto stmt = _conn.prepare(insertSql());
+        auto pipeline = _conn.beginPipeline();
+
+        for (const auto& entity : list) {
+            bindInsertParams(stmt.get(), entity);
+            stmt->executeUpdate();
+        }
+        if (!pipeline) {
+            return;  // no pipelining: each executeUpdate() already ran
+        }
+
+        auto results = pipeline->sync();
+        pipeline.reset();  // leave pipeline mode before the caller commits
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            if (!results[i].ok) {
+                throw DBException(DBErrorCode::QUERY_FAILED,
+                                  "Repository::insertBatch: row " + std::to_string(i) + ": " + results[i].error);
+            }
+        }
+    }
+
+    // Bulk load: one COPY for the whole batch, fields written in
+    // EntityTraits<Entity>::columns order (primary key skipped, as in insertPS)
+    void insertBatchCopy(const std::vector<Entity>& list) {
+        std::vector<std::string> columns;
         std::apply([&](auto&&... col) {
-            ((buildUpdateSet(oss, col, e, first)), ...);
+            ((appendColumnName(columns, col, true)), ...);
         }, EntityTraits<Entity>::columns);
-        
-        // Add WHERE clause with primary key
-        oss << " WHERE " << EntityTraits<Entity>::primaryKey << "=";
+
+        auto writer = _conn.beginBulkInsert(std::string(EntityTraits<Entity>::tableName), columns);
+        if (!writer) {
+            for (const auto& entity : list) {
+                insertPS(entity);
+            }
+            return;
+        }
+
+        for (const auto& entity : list) {
+            writer->startRow();
+            std::apply([&](auto&&... col) {
+                ((writeBulkField(writer.get(), col, entity, true)), ...);
+            }, EntityTraits<Entity>::columns);
+        }
+        writer->finish();
+    }
+
+    // Multi-row VALUES: as many entities per statement as the bind parameter
+    // limit allows. The rows left over after the full chunks go out in
+    // power-of-two chunks, so whatever the batch sizes only a few dozen
+    // distinct SQL texts (and server-side statements) ever exist.
+    void insertBatchMultiRow(const std::vector<Entity>& list) {
+        std::size_t columnCount = 0;
         std::apply([&](auto&&... col) {
-            ((buildWhereClause(oss, col, e)), ...);
+            ((columnCount += (col.name == EntityTraits<Entity>::primaryKey ? 0 : 1)), ...);
         }, EntityTraits<Entity>::columns);
-        
-        _conn.executeQuery(oss.str());
+        if (columnCount == 0) {
+            return;
+        }
+
+        const std::size_t maxRows = MAX_BIND_PARAMETERS / columnCount;
+        std::size_t rows = 0;
+        for (std::size_t offset = 0; offset < list.size(); offset += rows) {
+            rows = multiRowChunk(list.size() - offset, maxRows);
+            auto stmt = _conn.prepare(multiRowInsertSql(rows));
+            int paramIndex = 1;
+            for (std::size_t i = offset; i < offset + rows; ++i) {
+                std::apply([&](auto&&... col) {
+                    ((bindParameter(stmt.get(), col, list[i], paramIndex, true)), ...);
+                }, EntityTraits<Entity>::columns);
+            }
+            stmt->executeUpdate();
+        }
     }
 
-    void remove(const Entity& e) {
+    // maxRows, or the largest power of two that fits in what is left
+    static std::size_t multiRowChunk(std::size_t remaining, std::size_t maxRows) {
+        if (remaining >= maxRows) {
+            return maxRows;
+        }
+        std::size_t rows = 1;
+        while (rows * 2 <= remaining) {
+            rows *= 2;
+        }
+        return rows;
+    }
+
+    const std::string& multiRowInsertSql(std::size_t rows) {
+        auto it = _multiRowSql.find(rows);
+        if (it != _multiRowSql.end()) {
+            return it->second;
+        }
+
         std::ostringstream oss;
-        oss << "DELETE FROM " << EntityTraits<Entity>::tableName 
-            << " WHERE " << EntityTraits<Entity>::primaryKey << "=";
-        
-        // Get primary key value
+        oss << "INSERT INTO " << EntityTraits<Entity>::tableName << " (";
+        bool first = true;
         std::apply([&](auto&&... col) {
-            ((buildWhereClause(oss, col, e)), ...);
+            ((buildColumnList(oss, col, first, true)), ...);
         }, EntityTraits<Entity>::columns);
-        
-        _conn.executeQuery(oss.str());
+        oss << ") VALUES ";
+
+        int paramIndex = 1;
+        for (std::size_t row = 0; row < rows; ++row) {
+            oss << (row == 0 ? "(" : ", (");
+            first = true;
+            std::apply([&](auto&&... col) {
+                ((buildPlaceholderList(oss, col, first, paramIndex, true)), ...);
+            }, EntityTraits<Entity>::columns);
+            oss << ")";
+        }
+        return _multiRowSql.emplace(rows, oss.str()).first->second;
     }
 
-    void insertPS(const Entity& e) {
+    // INSERT INTO t (c1, ..) SELECT * FROM unnest($1::int4[], ..)
+    // ON CONFLICT (pk) DO UPDATE SET c2 = EXCLUDED.c2, ..
+    const std::string& upsertBatchSql() {
+        if (!_upsertSql.empty()) {
+            return _upsertSql;
+        }
+
         std::ostringstream oss;
         oss << "INSERT INTO " << EntityTraits<Entity>::tableName << " (";
-        
-        // Build column list (skip primary key if auto-increment)
         bool first = true;
+        std::apply([&](auto&&... col) {
+            ((buildColumnList(oss, col, first, false)), ...);
+        }, EntityTraits<Entity>::columns);
+
+        oss << ") SELECT * FROM unnest(";
+        first = true;
         int paramIndex = 1;
         std::apply([&](auto&&... col) {
-            ((buildColumnList(oss, col, first, true)), ...);
+            ((buildArrayPlaceholder(oss, col, first, paramIndex)), ...);
         }, EntityTraits<Entity>::columns);
-        
-        oss << ") VALUES (";
-        
-        // Build placeholder list
+
+        oss << ") ON CONFLICT (" << EntityTraits<Entity>::primaryKey << ") DO ";
+        std::ostringstream set;
         first = true;
         std::apply([&](auto&&... col) {
-            ((buildPlaceholderList(oss, col, first, paramIndex, true)), ...);
+            ((buildExcludedSet(set, col, first)), ...);
         }, EntityTraits<Entity>::columns);
-        
+        if (first) {
+            oss << "NOTHING";  // key-only entity
+        } else {
+            oss << "UPDATE SET " << set.str();
+        }
+
+        _upsertSql = oss.str();
+        return _upsertSql;
+    }
+
+    // SELECT * FROM t WHERE pk IN ($1, .., $count)
+    const std::string& inListSql(std::size_t count) {
+        auto it = _inListSql.find(count);
+        if (it != _inListSql.end()) {
+            return it->second;
+        }
+
+        std::ostringstream oss;
+        oss << EntitySql<Entity>::selectAll.view() << " WHERE " << EntityTraits<Entity>::primaryKey << " IN (";
+        for (std::size_t i = 1; i <= count; ++i) {
+            oss << (i == 1 ? "$" : ", $") << i;
+        }
         oss << ")";
-        
-        auto stmt = _conn.prepare(oss.str());
-        
-        // Bind parameters
-        paramIndex = 1;
+        return _inListSql.emplace(count, oss.str()).first->second;
+    }
+
+    static int primaryKeyOf(const Entity& e) {
+        int key = 0;
         std::apply([&](auto&&... col) {
-            ((bindParameter(stmt.get(), col, e, paramIndex, true)), ...);
+            ((col.name == EntityTraits<Entity>::primaryKey ? assignKey(key, e.*(col.member)) : void()), ...);
         }, EntityTraits<Entity>::columns);
-        
-        stmt->executeUpdate();
+        return key;
     }
 
-    void insertBatch(const std::vector<Entity>& list) {
-        auto txn = _conn.beginTransaction();
-        try {
-            for (const auto& entity : list) {
-                insertPS(entity);
-            }
-            txn->commit();
-        } catch (...) {
-            txn->rollback();
-            throw;
+    // Instantiated for every column type; only an int key is read
+    template<typename FieldType>
+    static void assignKey(int& key, const FieldType& value) {
+        if constexpr (std::is_same_v<FieldType, int>) {
+            key = value;
         }
     }
 
-protected:
+    static const std::string& insertSql() {
+        static const std::string sql(EntitySql<Entity>::insert.view());
+        return sql;
+    }
+
+    void bindInsertParams(IDBPreparedStatement* stmt, const Entity& e) {
+        int paramIndex = 1;
+        std::apply([&](auto&&... col) {
+            ((bindParameter(stmt, col, e, paramIndex, true)), ...);
+        }, EntityTraits<Entity>::columns);
+    }
+
     void mapRowToEntity(IDBRow& row, Entity& e) {
         // Map columns to entity fields
         size_t colIndex = 0;
@@ -184,90 +500,118 @@ protected:
     }
 
     template<typename Col>
-    void buildValuesList(std::ostringstream& oss, const Col& col, const Entity& e, bool& first, bool skipPrimaryKey) {
+    void buildPlaceholderList(std::ostringstream& oss, const Col& col, bool& first, int& paramIndex, bool skipPrimaryKey) {
         if (skipPrimaryKey && col.name == EntityTraits<Entity>::primaryKey) {
             return;
         }
         if (!first) oss << ", ";
+        oss << "$" << paramIndex++;
+        first = false;
+    }
+
+    template<typename Col>
+    void bindParameter(IDBPreparedStatement* stmt, const Col& col, const Entity& e, int& paramIndex, bool skipPrimaryKey) {
+        if (skipPrimaryKey && col.name == EntityTraits<Entity>::primaryKey) {
+            return;
+        }
         
-        using FieldType = typename std::remove_reference_t<decltype(e.*(col.member))>;
-        if constexpr (std::is_same_v<FieldType, std::string>) {
-            oss << "'" << escapeString(e.*(col.member)) << "'";
+        using FieldType = std::decay_t<decltype(e.*(col.member))>;
+        if constexpr (std::is_same_v<FieldType, int>) {
+            stmt->bindInt(paramIndex++, e.*(col.member));
+        } else if constexpr (std::is_same_v<FieldType, double>) {
+            stmt->bindDouble(paramIndex++, e.*(col.member));
+        } else if constexpr (std::is_same_v<FieldType, std::string>) {
+            stmt->bindString(paramIndex++, e.*(col.member));
+        }
+    }
+
+    void bindPrimaryKey(IDBPreparedStatement* stmt, const Entity& e, int& paramIndex) {
+        std::apply([&](auto&&... col) {
+            ((col.name == EntityTraits<Entity>::primaryKey ? bindParameter(stmt, col, e, paramIndex, false)
+                                                           : void()), ...);
+        }, EntityTraits<Entity>::columns);
+    }
+
+    template<typename Col>
+    void buildArrayPlaceholder(std::ostringstream& oss, const Col& col, bool& first, int& paramIndex) {
+        using FieldType = std::decay_t<decltype(std::declval<const Entity&>().*(col.member))>;
+        if (!first) oss << ", ";
+        oss << "$" << paramIndex++;
+        if constexpr (std::is_same_v<FieldType, int>) {
+            oss << "::int4[]";
+        } else if constexpr (std::is_same_v<FieldType, double>) {
+            oss << "::float8[]";
+        } else if constexpr (std::is_same_v<FieldType, std::string>) {
+            oss << "::text[]";
         } else {
-            oss << e.*(col.member);
+            static_assert(sizeof(FieldType) == 0, "upsertBatch: unsupported column type");
         }
         first = false;
     }
 
     template<typename Col>
-    void buildUpdateSet(std::ostringstream& oss, const Col& col, const Entity& e, bool& first) {
+    void buildExcludedSet(std::ostringstream& oss, const Col& col, bool& first) {
         if (col.name == EntityTraits<Entity>::primaryKey) {
-            return;  // Skip primary key in SET clause
+            return;
         }
         if (!first) oss << ", ";
-        
-        oss << col.name << "=";
-        using FieldType = typename std::remove_reference_t<decltype(e.*(col.member))>;
-        if constexpr (std::is_same_v<FieldType, std::string>) {
-            oss << "'" << escapeString(e.*(col.member)) << "'";
-        } else {
-            oss << e.*(col.member);
-        }
+        oss << col.name << " = EXCLUDED." << col.name;
         first = false;
     }
 
     template<typename Col>
-    void buildWhereClause(std::ostringstream& oss, const Col& col, const Entity& e) {
-        if (col.name == EntityTraits<Entity>::primaryKey) {
-            using FieldType = typename std::remove_reference_t<decltype(e.*(col.member))>;
-            if constexpr (std::is_same_v<FieldType, std::string>) {
-                oss << "'" << escapeString(e.*(col.member)) << "'";
-            } else {
-                oss << e.*(col.member);
-            }
+    void bindColumnArray(IDBPreparedStatement* stmt, const Col& col, const std::vector<Entity>& list, int& paramIndex) {
+        using FieldType = std::decay_t<decltype(std::declval<const Entity&>().*(col.member))>;
+        std::vector<FieldType> values;
+        values.reserve(list.size());
+        for (const auto& e : list) {
+            values.push_back(e.*(col.member));
+        }
+
+        if constexpr (std::is_same_v<FieldType, int>) {
+            stmt->bindIntArray(paramIndex++, values);
+        } else if constexpr (std::is_same_v<FieldType, double>) {
+            stmt->bindDoubleArray(paramIndex++, values);
+        } else if constexpr (std::is_same_v<FieldType, std::string>) {
+            stmt->bindStringArray(paramIndex++, values);
         }
     }
 
     template<typename Col>
-    void buildPlaceholderList(std::ostringstream& oss, const Col& col, bool& first, int& paramIndex, bool skipPrimaryKey) {
+    void appendColumnName(std::vector<std::string>& columns, const Col& col, bool skipPrimaryKey) {
         if (skipPrimaryKey && col.name == EntityTraits<Entity>::primaryKey) {
             return;
         }
-        if (!first) oss << ", ";
-        oss << "$" << paramIndex++;
-        first = false;
+        columns.emplace_back(col.name);
     }
 
     template<typename Col>
-    void bindParameter(IDBPreparedStatement* stmt, const Col& col, const Entity& e, int& paramIndex, bool skipPrimaryKey) {
+    void writeBulkField(IDBBulkWriter* writer, const Col& col, const Entity& e, bool skipPrimaryKey) {
         if (skipPrimaryKey && col.name == EntityTraits<Entity>::primaryKey) {
             return;
         }
-        
-        using FieldType = typename std::remove_reference_t<decltype(e.*(col.member))>;
+
+        using FieldType = std::decay_t<decltype(e.*(col.member))>;
         if constexpr (std::is_same_v<FieldType, int>) {
-            stmt->bindInt(paramIndex++, e.*(col.member));
+            writer->writeInt(e.*(col.member));
         } else if constexpr (std::is_same_v<FieldType, double>) {
-            stmt->bindDouble(paramIndex++, e.*(col.member));
+            writer->writeDouble(e.*(col.member));
         } else if constexpr (std::is_same_v<FieldType, std::string>) {
-            stmt->bindString(paramIndex++, e.*(col.member));
-        }
-    }
-
-    std::string escapeString(const std::string& str) {
-        std::string escaped;
-        for (char c : str) {
-            if (c == '\'') {
-                escaped += "''";  // SQL standard: double the single quote
-            } else if (c == '\\') {
-                escaped += "\\\\";  // Escape backslash for safety
-            } else {
-                escaped += c;
-            }
+            writer->writeString(e.*(col.member));
+        } else {
+            writer->writeNull();
         }
-        return escaped;
     }
 
 private:
+    // PostgreSQL wire protocol limit on parameters per statement
+    static constexpr std::size_t MAX_BIND_PARAMETERS = 65535;
+    // Ids per IN (...) list where arrays cannot be bound
+    static constexpr std::size_t IN_LIST_CHUNK = 250;
+
     IDBConnection& _conn;
+    BatchInsertMode _batchInsertMode{BatchInsertMode::Statements};
+    std::unordered_map<std::size_t, std::string> _multiRowSql;  // rows per chunk -> INSERT text
+    std::string _upsertSql;
+    std::unordered_map<std::size_t, std::string> _inListSql;  // ids per list -> SELECT text
 };
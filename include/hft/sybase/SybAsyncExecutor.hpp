@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef WITH_SYBASE
+
+class SybConnection;
+class SybReader;
+
+// Runs queries on many SybConnections from one thread. submit() sends the
+// batch with dbsqlsend() and returns; poll() waits on all of the
+// connections' sockets at once and completes every query whose server
+// has answered (dbsqlok()), running callbacks and fulfilling futures in
+// the calling thread. A connection carries one query at a time: its
+// reader must be read or destroyed before the connection is submitted
+// to again. Row fetching itself still happens in the reader's next().
+//
+// Not thread-safe: use one executor per extraction thread.
+class SybAsyncExecutor {
+public:
+    // Completion handler; error is empty on success, reader null otherwise
+    using QueryCallback = std::function<void(std::unique_ptr<SybReader> reader, const std::string& error)>;
+
+    SybAsyncExecutor() = default;
+    // Cancels queries still pending; their callbacks get an error
+    ~SybAsyncExecutor();
+
+    SybAsyncExecutor(const SybAsyncExecutor&) = delete;
+    SybAsyncExecutor& operator=(const SybAsyncExecutor&) = delete;
+
+    // Throws DBException if the query cannot be sent (callback not called)
+    void submit(SybConnection& conn, const std::string& sql, QueryCallback callback);
+    // The future holds a DBException if the query fails
+    std::future<std::unique_ptr<SybReader>> submit(SybConnection& conn, const std::string& sql);
+
+    // Waits up to timeoutMs (-1: no limit) for any pending query to be
+    // answered; returns how many completed. If a callback throws, the
+    // other answered queries are still completed and the first exception
+    // is rethrown afterwards.
+    std::size_t poll(int timeoutMs);
+    // poll() until nothing is pending
+    void wait();
+
+    std::size_t pending() const { return _pending.size(); }
+
+private:
+    struct PendingQuery {
+        SybConnection* conn{nullptr};
+        QueryCallback callback;
+    };
+
+    std::vector<PendingQuery> _pending;
+};
+
+#endif
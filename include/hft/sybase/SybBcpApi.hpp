@@ -0,0 +1,70 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Host-side type of a bulk-copy column (SYBINT4, SYBFLT8, SYBCHAR)
+enum class SybBcpType { Int, Float, Char };
+
+// Seam over the DB-Lib bulk-copy calls, so SybBcpWriter and SybBcpReader
+// can be driven by a mock in tests. Column numbers are 1-based as in
+// DB-Lib; bool/long results report FAIL as false/-1.
+class ISybBcpApi {
+public:
+    virtual ~ISybBcpApi() = default;
+
+    // Table column names in ordinal order; must be called before init()
+    virtual std::vector<std::string> tableColumns(const std::string& table) = 0;
+
+    // bcp_init: loads (DB_IN) use program variables, extracts (DB_OUT)
+    // write hostFile
+    virtual bool init(const std::string& table, const std::string& hostFile, bool out) = 0;
+
+    // Loading: bcp_bind, then per row bcp_colptr/bcp_collen and bcp_sendrow.
+    // setColumn() with data == nullptr sends NULL.
+    virtual bool bind(int tableColumn, SybBcpType type) = 0;
+    virtual bool setColumn(int tableColumn, const void* data, int length) = 0;
+    virtual bool sendRow() = 0;
+    virtual long batch() = 0;
+    virtual long done() = 0;
+    // Drop rows sent since the last batch() (dbcancel)
+    virtual void cancel() = 0;
+
+    // Extracting: bcp_columns, bcp_colfmt, bcp_exec. Every host column is
+    // character data preceded by a native 4-byte length (0 for NULL).
+    virtual bool setHostColumns(int count) = 0;
+    virtual bool setHostFormat(int hostColumn, int tableColumn) = 0;
+    virtual long exec() = 0;
+};
+
+#ifdef WITH_SYBASE
+
+// Forward declare DB-Lib type
+struct tds_dbproc;
+typedef struct tds_dbproc DBPROCESS;
+
+// ISybBcpApi over a live DBPROCESS. The login must have been opened with
+// BCP_SETL(login, TRUE) (SybConnection does this).
+class SybDbLibBcpApi : public ISybBcpApi {
+public:
+    explicit SybDbLibBcpApi(DBPROCESS* dbproc);
+
+    std::vector<std::string> tableColumns(const std::string& table) override;
+    bool init(const std::string& table, const std::string& hostFile, bool out) override;
+
+    bool bind(int tableColumn, SybBcpType type) override;
+    bool setColumn(int tableColumn, const void* data, int length) override;
+    bool sendRow() override;
+    long batch() override;
+    long done() override;
+    void cancel() override;
+
+    bool setHostColumns(int count) override;
+    bool setHostFormat(int hostColumn, int tableColumn) override;
+    long exec() override;
+
+private:
+    DBPROCESS* _dbproc{nullptr};
+    std::vector<SybBcpType> _types;  // bound type per table column (index = column - 1)
+};
+
+#endif
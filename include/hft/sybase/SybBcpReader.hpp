@@ -0,0 +1,50 @@
+#pragma once
+#include "db/IDBReader.hpp"
+#include "db/IDBRow.hpp"
+#include "sybase/SybBcpApi.hpp"
+#include "sybase/SybValue.hpp"
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Bulk extract through DB-Lib bcp (bcp_init DB_OUT, bcp_colfmt, bcp_exec).
+// DB-Lib bcp out always writes a host data file, so the table is exported
+// there first, every column as character data with a 4-byte length
+// prefix, and rows are then streamed back from the file one at a time.
+// Empty values read as NULL (Sybase stores '' as a single space).
+// A temporary file is used unless hostFile is given; it is removed when
+// the reader is destroyed.
+class SybBcpReader : public IDBReader {
+public:
+    SybBcpReader(std::unique_ptr<ISybBcpApi> api, const std::string& table,
+                 const std::string& hostFile = std::string());
+    ~SybBcpReader() override;
+
+    bool next() override;
+    IDBRow& row() override;
+
+    // Table column names, in the order values appear in each row
+    const std::vector<std::string>& columns() const { return _columns; }
+    // Rows bcp_exec reported copying
+    long rowCount() const { return _rowCount; }
+
+private:
+    class Row : public IDBRow {
+    public:
+        std::size_t columnCount() const override { return _values.size(); }
+        const IDBValue& operator[](std::size_t idx) const override;
+
+        std::vector<SybValue> _values;
+    };
+
+    std::unique_ptr<ISybBcpApi> _api;
+    std::vector<std::string> _columns;
+    std::string _hostFile;
+    bool _ownsFile{false};
+    std::ifstream _in;
+    std::vector<std::string> _fields;  // current row; the values view these
+    Row _row;
+    long _rowCount{0};
+    bool _hasRow{false};
+};
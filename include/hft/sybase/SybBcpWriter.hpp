@@ -0,0 +1,63 @@
+#pragma once
+#include "db/IDBBulkWriter.hpp"
+#include "sybase/SybBcpApi.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Bulk load through DB-Lib bcp (bcp_init DB_IN, bcp_bind, bcp_sendrow).
+// Each row is held in per-column program variables and sent when the next
+// row starts or on finish(); every batchSize rows bcp_batch() commits what
+// has been sent so far.
+//
+// Host types are bound from the first row: writeInt() binds SYBINT4,
+// writeDouble() SYBFLT8, writeString() and writeNull() SYBCHAR. Later rows
+// may write NULL anywhere, ints into a double column, and anything into a
+// character column (formatted as text); other type changes throw.
+// Sybase has no empty strings, so "" loads as NULL.
+//
+// Destroying an unfinished writer cancels the rows sent since the last
+// batch; earlier batches stay committed.
+class SybBcpWriter : public IDBBulkWriter {
+public:
+    static constexpr long DEFAULT_BATCH_SIZE = 10000;
+
+    SybBcpWriter(std::unique_ptr<ISybBcpApi> api, const std::string& table,
+                 const std::vector<std::string>& columns,
+                 long batchSize = DEFAULT_BATCH_SIZE);
+    ~SybBcpWriter() override;
+
+    void startRow() override;
+    void writeNull() override;
+    void writeInt(int value) override;
+    void writeDouble(double value) override;
+    void writeString(const std::string& value) override;
+
+    long finish() override;
+
+    void setBatchSize(long rows) { _batchSize = rows > 0 ? rows : 0; }
+
+private:
+    // Program variable for one column; bcp_colptr points into it
+    struct Field {
+        int tableColumn{0};
+        SybBcpType type{SybBcpType::Char};
+        bool isNull{true};
+        int intValue{0};
+        double doubleValue{0.0};
+        std::string text;
+    };
+
+    Field& nextField(const char* caller);
+    void sendRow();
+
+    std::unique_ptr<ISybBcpApi> _api;
+    std::vector<Field> _fields;
+    std::vector<SybBcpType> _written;  // types written in the current row
+    long _batchSize{DEFAULT_BATCH_SIZE};
+    long _rows{0};
+    std::size_t _fieldsInRow{0};
+    bool _bound{false};
+    bool _inRow{false};
+    bool _active{false};
+};
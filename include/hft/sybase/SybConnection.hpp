@@ -1,7 +1,11 @@
 #pragma once
 #include "db/IDBConnection.hpp"
 #include <memory>
+#include <functional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 #ifdef WITH_SYBASE
 
@@ -11,6 +15,8 @@ typedef struct tds_dbproc DBPROCESS;
 struct tds_login;
 typedef struct tds_login LOGINREC;
 
+class SybReader;
+
 class SybConnection : public IDBConnection {
 public:
     explicit SybConnection(const std::string& conninfo);
@@ -19,23 +25,109 @@ public:
     std::unique_ptr<IDBReader>
     executeQuery(const std::string& sql) override;
 
+    // Sends the statements as one command batch (one dbsqlexec() round
+    // trip). The reader starts on the first result set with rows; use
+    // SybReader::nextResultSet() for the rest and rowCounts() for the
+    // per-statement DBCOUNT.
+    std::unique_ptr<SybReader>
+    executeBatch(const std::vector<std::string>& statements);
+
+    // executeBatch() with every result discarded; returns the row count of
+    // each statement in order
+    std::vector<long>
+    executeBatchUpdate(const std::vector<std::string>& statements);
+
     std::unique_ptr<IDBPreparedStatement>
     prepare(const std::string& sql) override;
 
     std::unique_ptr<IDBTransaction>
     beginTransaction() override;
 
+    // Bulk load through bcp_sendrow (see SybBcpWriter)
+    std::unique_ptr<IDBBulkWriter>
+    beginBulkInsert(const std::string& table, const std::vector<std::string>& columns) override;
+
+    // Bulk extract of a whole table or view through bcp out (see SybBcpReader)
+    std::unique_ptr<IDBReader>
+    beginBulkExtract(const std::string& table);
+
+    // Rows per bcp_batch() commit for bulk loads; 0 commits only at the end
+    void setBcpBatchSize(long rows) { _bcpBatchSize = rows > 0 ? rows : 0; }
+    long bcpBatchSize() const { return _bcpBatchSize; }
+
+    // Prepared statements run as RPCs against generated procedures when
+    // on; off (the default) splices parameters into the SQL as literals.
+    // Turning it on means executing DDL in the current database: the
+    // login needs CREATE PROCEDURE permission, and procedures of a session
+    // that dies without closing stay behind (named hft_rpc_<spid>_<n>)
+    // until a later session with the same spid reuses the name.
+    void setRpcExecution(bool on) { _rpcExecution = on; }
+    bool rpcExecution() const { return _rpcExecution; }
+
+    // Name of the procedure wrapping `body` (SQL using @p1..@pN) with the
+    // given parameter declarations, created on first use and dropped when
+    // the connection closes. Returns nullptr if it cannot be created, and
+    // the statement falls back to literal SQL. ASE refuses DDL inside a
+    // transaction, so nothing new is created while a beginTransaction()
+    // transaction is open (procedures created earlier are still used);
+    // run a statement once outside the transaction to get its procedure.
+    const std::string* rpcProcedure(const std::string& body, const std::string& declarations);
+    // Executions that fell back to literal SQL because rpcProcedure()
+    // returned nullptr
+    unsigned long rpcFallbacks() const { return _rpcFallbacks; }
+
+    // Receives one TEXT/IMAGE value in chunks: each chunk of row `row`
+    // with last false, then an empty chunk with last true
+    using TextChunkCallback = std::function<void(long row, std::string_view chunk, bool last)>;
+
+    // Runs sql, which must select a single TEXT or IMAGE column, and
+    // streams each value through dbreadtext() in chunkSize pieces, so no
+    // value is ever held in memory whole. Raises the session TEXTSIZE to
+    // its maximum first so nothing is truncated, and restores the previous
+    // setting afterwards, also on failure. NULL reads as an empty value.
+    // Returns the number of rows.
+    long streamText(const std::string& sql, const TextChunkCallback& callback,
+                    std::size_t chunkSize = DEFAULT_TEXT_CHUNK);
+    static constexpr std::size_t DEFAULT_TEXT_CHUNK = 64 * 1024;
+
+    // Non-blocking execution (see SybAsyncExecutor). sendQuery() hands the
+    // batch to the server with dbsqlsend() and returns at once; when
+    // socket() turns readable the server has answered and finishQuery()
+    // (dbsqlok()) returns its reader without waiting. One query at a time.
+    void sendQuery(const std::string& sql);
+    std::unique_ptr<SybReader> finishQuery();
+    // Abandon the pending query (dbcancel())
+    void cancelQuery();
+    bool queryPending() const { return _queryPending; }
+    // Descriptor to wait on for readability, or -1
+    int socket() const;
+
     // Access to underlying connection
     DBPROCESS* getDbProcess() { return _dbproc; }
 
 private:
     std::string _conninfo;
     DBPROCESS* _dbproc{nullptr};
+    long _bcpBatchSize{10000};
+    bool _rpcExecution{false};
+    bool _queryPending{false};
+    // declarations + '\0' + body -> procedure name ("" if creation failed)
+    std::unordered_map<std::string, std::string> _rpcProcedures;
+    std::string _rpcPrefix;
+    unsigned long _rpcCounter{0};
+    unsigned long _rpcFallbacks{0};
+    // Open beginTransaction() transactions; kept by SybTransaction
+    int _transactionDepth{0};
+    friend class SybTransaction;
     static bool _initialized;
     
     void parseConnInfo(const std::string& conninfo, 
                       std::string& server, std::string& user, 
                       std::string& password, std::string& database);
+    // Runs a batch and discards its results; false on failure
+    bool runBatch(const std::string& sql);
+    // First column of the last row of a single-value query, or -1
+    long selectLong(const char* sql);
 };
 
 #endif
@@ -1,5 +1,7 @@
 #pragma once
 #include "db/IDBPreparedStatement.hpp"
+#include "sybase/SybSqlTemplate.hpp"
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -8,6 +10,13 @@
 // Forward declaration
 class SybConnection;
 
+// $1..$N parameters are executed as an RPC (dbrpcinit/dbrpcparam/
+// dbrpcsend) with typed values against a procedure the connection
+// generates once per SQL text and parameter signature (see
+// SybConnection::rpcProcedure), so ASE compiles the statement once and
+// reuses its plan. If RPC execution is off (the default) or the
+// procedure cannot be created, the values are spliced into the SQL as
+// literals instead.
 class SybPreparedStatement : public IDBPreparedStatement {
 public:
     explicit SybPreparedStatement(std::string sql, SybConnection* conn);
@@ -21,11 +30,17 @@ public:
     void executeUpdate() override;
 
 private:
-    std::string _sql;
-    std::vector<std::string> _params;
+    using Param = SybSqlParam;
+
+    SybSqlTemplate _template;  // the SQL, split once at prepare time
+    std::vector<Param> _params;
+    std::vector<std::string> _paramNames;
     SybConnection* _conn{nullptr};
     
-    std::string buildFinalSQL();
+    Param& param(int index, const char* caller);
+    std::string buildDeclarations() const;
+    // Sends the statement (RPC or literal batch) and checks it was accepted
+    void send(const char* caller);
 };
 
 
@@ -1,6 +1,7 @@
 #pragma once
 #include "db/IDBReader.hpp"
-#include <memory>
+#include "sybase/SybRow.hpp"
+#include <vector>
 
 #ifdef WITH_SYBASE
 
@@ -11,17 +12,50 @@ typedef struct tds_dbproc DBPROCESS;
 
 class IDBRow;
 
+// Reads the result sets of the command batch running on dbproc. The row
+// buffers are bound once per result set and refilled in place by each
+// dbnextrow(), so row() always returns the same SybRow. nextResultSet()
+// moves to the next statement that returns rows; the DBCOUNT of every
+// statement finished so far is kept in rowCounts(), including DML
+// statements that returned no columns. COMPUTE rows are skipped unless
+// setComputeRows(true), in which case next() stops on them too and
+// computeId() tells them apart. Destroying the reader cancels whatever
+// results are left so the connection can run its next command.
 class SybReader : public IDBReader {
 public:
-    explicit SybReader(DBPROCESS* dbproc);
+    // The batch has been executed (dbsqlexec()/dbsqlok()) but dbresults()
+    // not called yet; the reader advances to the first result set with
+    // columns. Without pending, dbresults() has already returned SUCCEED.
+    explicit SybReader(DBPROCESS* dbproc, bool pending = false);
     ~SybReader() override;
 
     bool next() override;
     IDBRow& row() override;
 
+    // Skips the rest of the current result set and moves to the next one
+    // with columns. Returns false once the batch has no more results.
+    bool nextResultSet();
+    // Row counts of the statements completed so far, in batch order
+    // (-1 where the server reported none)
+    const std::vector<long>& rowCounts() const { return _rowCounts; }
+
+    void setComputeRows(bool on) { _computeRows = on; }
+    // Compute id of the current row, 0 for a regular row
+    int computeId() const { return _computeId; }
+
 private:
     DBPROCESS* _dbproc{nullptr};
-    std::unique_ptr<IDBRow> _row;
+    SybRow _row;
+    SybRow _computeRow;
+    std::vector<long> _rowCounts;
+    bool _hasRow{false};
+    bool _inResultSet{false};   // current set not yet read to the end
+    bool _done{false};          // dbresults() returned NO_MORE_RESULTS
+    bool _computeRows{false};
+    int _computeId{0};
+
+    void finishResultSet();
+    bool advance();
 };
 
 
@@ -1,7 +1,8 @@
 #pragma once
 #include "db/IDBRow.hpp"
+#include "sybase/SybValue.hpp"
+#include <cstdint>
 #include <vector>
-#include <memory>
 
 #ifdef WITH_SYBASE
 
@@ -11,16 +12,46 @@ typedef struct tds_dbproc DBPROCESS;
 
 class IDBValue;
 
+// Typed row buffers for one DB-Lib result set. bind() gives every column a
+// buffer of its native type (INTBIND, BIGINTBIND, FLT8BIND, or
+// NTBSTRINGBIND for character, exact numeric, date and binary columns) and
+// registers it with dbbind()/dbnullbind(), so dbnextrow() writes each row
+// straight into them and the SybValue views never change between rows.
+// TEXT/IMAGE columns are not bound, their size being limited only by
+// TEXTSIZE; refresh() re-points them at dbdata() after each row.
 class SybRow : public IDBRow {
 public:
-    explicit SybRow(DBPROCESS* dbproc);
+    SybRow() = default;
     ~SybRow() override;
 
+    SybRow(const SybRow&) = delete;
+    SybRow& operator=(const SybRow&) = delete;
+
+    // Bind to the current result set (after dbresults() returned SUCCEED).
+    // Rebinding keeps the text buffers' storage, growing it when a column
+    // needs more.
+    void bind(DBPROCESS* dbproc);
+    // Update the unbound TEXT/IMAGE cells after dbnextrow()
+    void refresh();
+    // Load the COMPUTE row dbnextrow() just returned as text cells
+    void loadCompute(DBPROCESS* dbproc, int computeId);
+
     std::size_t columnCount() const override;
     const IDBValue& operator[](std::size_t idx) const override;
 
 private:
-    std::vector<std::unique_ptr<IDBValue>> _values;
+    struct Buffer {
+        std::int32_t indicator{0};
+        std::int32_t intValue{0};
+        std::int64_t int64Value{0};
+        double doubleValue{0.0};
+        std::vector<char> text;
+    };
+
+    DBPROCESS* _dbproc{nullptr};
+    std::vector<Buffer> _buffers;   // sized once per bind(); dbbind() holds their addresses
+    std::vector<SybValue> _values;
+    std::vector<int> _unbound;      // 1-based TEXT/IMAGE columns
 };
 
 #endif
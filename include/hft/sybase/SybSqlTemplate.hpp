@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One value bound to a $n placeholder
+struct SybSqlParam {
+    enum class Type { Unbound, Int, Double, String };
+    Type type{Type::Unbound};
+    std::int32_t intValue{0};
+    double doubleValue{0.0};
+    std::string text;
+};
+
+// SQL with $1..$N placeholders, split once into literal segments and
+// parameter slots so each execution only concatenates. Quoted literals
+// are never split, and $0 is not a placeholder. Needs no DB-Lib.
+class SybSqlTemplate {
+public:
+    explicit SybSqlTemplate(const std::string& sql);
+
+    // The SQL with $n rewritten to @pn, for the body of an RPC procedure
+    const std::string& rpcBody() const { return _rpcBody; }
+
+    // The SQL with each $n replaced by params[n-1] as a literal; strings
+    // are quoted with embedded quotes doubled. Unbound slots stay $n for
+    // the server to reject.
+    std::string render(const std::vector<SybSqlParam>& params) const;
+
+private:
+    // _segments[0] $_slots[0] _segments[1] ... $_slots[k-1] _segments[k],
+    // slots being 0-based parameter indexes
+    std::vector<std::string> _segments;
+    std::vector<int> _slots;
+    std::size_t _segmentBytes{0};
+    std::string _rpcBody;
+};
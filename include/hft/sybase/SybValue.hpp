@@ -1,23 +1,55 @@
 #pragma once
 #include "db/IDBValue.hpp"
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
 
-#ifdef WITH_SYBASE
-
+// Non-owning view over one cell. Numeric cells point at the typed buffer
+// SybRow registered with dbbind(), so the view is set up once per result
+// set and sees every row dbnextrow() writes there; nothing is converted
+// until a getter is called. Text cells view a character buffer, either
+// NUL-terminated (bound with NTBSTRINGBIND) or given with its length.
 class SybValue : public IDBValue {
 public:
-    SybValue();
-    SybValue(std::string v, bool isNull);
+    enum class Kind { Int, Int64, Double, Text };
+
+    SybValue() = default;
+    // Text view of len bytes
+    SybValue(std::string_view v, bool isNull);
 
     bool isNull() const override;
     int asInt() const override;
     double asDouble() const override;
     std::string asString() const override;
 
+    // Typed getters; text cells fall back to parsing
+    std::int64_t asInt64() const;
+    // No copy; valid until the reader moves to the next row
+    std::string_view asStringView() const;
+
+    // Views over dbbind() buffers. nullIndicator is the dbnullbind()
+    // indicator (-1 for NULL); without one the cell is never NULL.
+    void bindInt(const std::int32_t* data, const std::int32_t* nullIndicator);
+    void bindInt64(const std::int64_t* data, const std::int32_t* nullIndicator);
+    void bindDouble(const double* data, const std::int32_t* nullIndicator);
+    void bindText(const char* data, const std::int32_t* nullIndicator);
+
+    // Re-point a text view at another cell
+    void assign(const char* data, std::size_t len, bool isNull) {
+        _kind = Kind::Text;
+        _data = nullptr;
+        _indicator = nullptr;
+        _text = isNull ? std::string_view() : std::string_view(data, len);
+        _null = isNull;
+    }
+
+    Kind kind() const { return _kind; }
+
 private:
-    std::string _value;
+    Kind _kind{Kind::Text};
+    const void* _data{nullptr};           // typed buffer or NUL-terminated text
+    const std::int32_t* _indicator{nullptr};
+    std::string_view _text;               // text given by length (when _data is null)
     bool _null{true};
 };
-
-
-#endif
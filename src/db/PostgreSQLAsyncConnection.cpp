@@ -0,0 +1,187 @@
+#include "db/PostgreSQLAsyncConnection.h"
+#include "db/PostgreSQLConnection.h"
+#include <stdexcept>
+
+namespace hft {
+namespace db {
+
+PostgreSQLAsyncConnection::PostgreSQLAsyncConnection() : conn_(nullptr), wantsWrite_(false) {}
+
+PostgreSQLAsyncConnection::~PostgreSQLAsyncConnection() {
+    close();
+}
+
+bool PostgreSQLAsyncConnection::open(const std::string& connectionString) {
+    close();
+    conn_ = PQconnectdb(connectionString.c_str());
+    
+    if (PQstatus(conn_) != CONNECTION_OK) {
+        lastError_ = PQerrorMessage(conn_);
+        PQfinish(conn_);
+        conn_ = nullptr;
+        return false;
+    }
+    
+    if (PQsetnonblocking(conn_, 1) != 0 || !PQenterPipelineMode(conn_)) {
+        lastError_ = PQerrorMessage(conn_);
+        PQfinish(conn_);
+        conn_ = nullptr;
+        return false;
+    }
+    
+    return true;
+}
+
+void PostgreSQLAsyncConnection::close() {
+    if (conn_) {
+        PQfinish(conn_);
+        conn_ = nullptr;
+    }
+    wantsWrite_ = false;
+    failAll("connection closed");
+}
+
+bool PostgreSQLAsyncConnection::isOpen() const {
+    return conn_ != nullptr && PQstatus(conn_) == CONNECTION_OK;
+}
+
+std::string PostgreSQLAsyncConnection::getLastError() const {
+    return lastError_;
+}
+
+int PostgreSQLAsyncConnection::socket() const {
+    return conn_ ? PQsocket(conn_) : -1;
+}
+
+bool PostgreSQLAsyncConnection::sendQuery(const std::string& sql, const std::vector<std::string>& params,
+                                          QueryCallback callback) {
+    if (!conn_) {
+        lastError_ = "connection is not open";
+        return false;
+    }
+    
+    std::vector<const char*> values;
+    values.reserve(params.size());
+    for (const auto& param : params) {
+        values.push_back(param.c_str());
+    }
+    
+    // One sync point per query: a failing query does not abort the others
+    if (!PQsendQueryParams(conn_, sql.c_str(), static_cast<int>(values.size()), nullptr,
+                           values.data(), nullptr, nullptr, 0) ||
+        !PQpipelineSync(conn_)) {
+        lastError_ = PQerrorMessage(conn_);
+        return false;
+    }
+    
+    PendingQuery query;
+    query.callback = std::move(callback);
+    pending_.push_back(std::move(query));
+    return flush();
+}
+
+std::future<std::shared_ptr<IResultSet>>
+PostgreSQLAsyncConnection::sendQuery(const std::string& sql, const std::vector<std::string>& params) {
+    auto promise = std::make_shared<std::promise<std::shared_ptr<IResultSet>>>();
+    auto future = promise->get_future();
+    
+    bool sent = sendQuery(sql, params, [promise](std::shared_ptr<IResultSet> result, const std::string& error) {
+        if (error.empty()) {
+            promise->set_value(std::move(result));
+        } else {
+            promise->set_exception(std::make_exception_ptr(std::runtime_error(error)));
+        }
+    });
+    if (!sent) {
+        promise->set_exception(std::make_exception_ptr(std::runtime_error(lastError_)));
+    }
+    return future;
+}
+
+bool PostgreSQLAsyncConnection::onReadable() {
+    if (!conn_) {
+        return false;
+    }
+    if (!PQconsumeInput(conn_)) {
+        lastError_ = PQerrorMessage(conn_);
+        failAll(lastError_);
+        return false;
+    }
+    
+    // Per query: its result(s), a NULL, then PGRES_PIPELINE_SYNC. Callbacks
+    // may send more queries or close the connection, so re-check conn_.
+    bool sawEnd = false;
+    while (conn_ && !pending_.empty() && !PQisBusy(conn_)) {
+        PGresult* res = PQgetResult(conn_);
+        if (!res) {
+            if (sawEnd) break;  // nothing more until further input
+            sawEnd = true;
+            continue;
+        }
+        sawEnd = false;
+        
+        ExecStatusType status = PQresultStatus(res);
+        PendingQuery& front = pending_.front();
+        if (status == PGRES_PIPELINE_SYNC) {
+            PQclear(res);
+            PendingQuery done = std::move(pending_.front());
+            pending_.pop_front();
+            
+            std::shared_ptr<IResultSet> result;
+            if (done.error.empty() && done.result) {
+                result = std::make_shared<PostgreSQLResultSet>(done.result);
+            } else if (done.result) {
+                PQclear(done.result);
+            }
+            if (done.callback) {
+                done.callback(std::move(result), done.error);
+            }
+            continue;
+        }
+        
+        if (status == PGRES_TUPLES_OK || status == PGRES_COMMAND_OK) {
+            // Keep the last result of a multi-statement query
+            if (front.result) PQclear(front.result);
+            front.result = res;
+        } else {
+            if (front.error.empty()) {
+                const char* msg = PQresultErrorMessage(res);
+                front.error = (msg && *msg) ? msg : PQresStatus(status);
+            }
+            PQclear(res);
+        }
+    }
+    
+    return conn_ ? flush() : false;
+}
+
+bool PostgreSQLAsyncConnection::onWritable() {
+    return conn_ ? flush() : false;
+}
+
+bool PostgreSQLAsyncConnection::flush() {
+    int rc = PQflush(conn_);
+    if (rc < 0) {
+        lastError_ = PQerrorMessage(conn_);
+        failAll(lastError_);
+        return false;
+    }
+    wantsWrite_ = (rc == 1);
+    return true;
+}
+
+void PostgreSQLAsyncConnection::failAll(const std::string& error) {
+    std::deque<PendingQuery> failed;
+    failed.swap(pending_);
+    for (auto& query : failed) {
+        if (query.result) {
+            PQclear(query.result);
+        }
+        if (query.callback) {
+            query.callback(nullptr, error);
+        }
+    }
+}
+
+} // namespace db
+} // namespace hft
@@ -1,21 +1,136 @@
 #include "db/PostgreSQLConnection.h"
+#include "pg/PgBinary.hpp"
 #include <cstring>
 #include <sstream>
 #include <cstdlib>
+#include <stdexcept>
 
 namespace hft {
 namespace db {
 
-static int statementCounter = 0;
+// PostgreSQLStatementRegistry implementation
+PostgreSQLStatementRegistry::PostgreSQLStatementRegistry()
+    : capacity_(DEFAULT_CAPACITY), nameCounter_(0), hits_(0), misses_(0), evictions_(0) {}
+
+std::string PostgreSQLStatementRegistry::makeKey(const std::string& sql, const std::vector<Oid>& types) {
+    std::string key;
+    key.reserve(sql.size() + 1 + types.size() * sizeof(Oid));
+    key.append(reinterpret_cast<const char*>(types.data()), types.size() * sizeof(Oid));
+    key.push_back('\0');
+    key.append(sql);
+    return key;
+}
+
+bool PostgreSQLStatementRegistry::acquire(PGconn* conn, const std::string& sql,
+                                          const std::vector<Oid>& types,
+                                          std::string& name, std::string& error) {
+    std::string key = makeKey(sql, types);
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        entries_.splice(entries_.begin(), entries_, it->second);
+        name = it->second->name;
+        ++hits_;
+        return true;
+    }
+
+    ++misses_;
+    std::string newName = "hft_stmt_" + std::to_string(++nameCounter_);
+    PGresult* result = PQprepare(conn, newName.c_str(), sql.c_str(),
+                                 static_cast<int>(types.size()), types.data());
+    if (PQresultStatus(result) != PGRES_COMMAND_OK) {
+        error = PQerrorMessage(conn);
+        PQclear(result);
+        return false;
+    }
+    PQclear(result);
+
+    entries_.push_front(Entry{std::move(key), newName});
+    index_[entries_.front().key] = entries_.begin();
+    evictOverflow(conn);
+    name = std::move(newName);
+    return true;
+}
+
+void PostgreSQLStatementRegistry::evictOverflow(PGconn* conn) {
+    while (entries_.size() > capacity_) {
+        const Entry& victim = entries_.back();
+        std::string deallocate = "DEALLOCATE " + victim.name;
+        PGresult* result = PQexec(conn, deallocate.c_str());
+        if (PQresultStatus(result) != PGRES_COMMAND_OK) {
+            // 26000: the statement is already gone (e.g. DISCARD ALL), so the
+            // entry can go too. Otherwise it still exists server-side: keep
+            // tracking it and retry on the next eviction.
+            const char* state = PQresultErrorField(result, PG_DIAG_SQLSTATE);
+            bool gone = state && std::strcmp(state, "26000") == 0;
+            evictionError_ = PQerrorMessage(conn);
+            PQclear(result);
+            if (!gone) {
+                return;
+            }
+        } else {
+            PQclear(result);
+        }
+        index_.erase(victim.key);
+        entries_.pop_back();
+        ++evictions_;
+    }
+}
+
+void PostgreSQLStatementRegistry::setCapacity(PGconn* conn, std::size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity == 0 ? 1 : capacity;
+    if (conn) {
+        evictOverflow(conn);
+    }
+}
+
+std::size_t PostgreSQLStatementRegistry::capacity() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_;
+}
+
+std::size_t PostgreSQLStatementRegistry::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+uint64_t PostgreSQLStatementRegistry::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+uint64_t PostgreSQLStatementRegistry::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+uint64_t PostgreSQLStatementRegistry::evictions() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return evictions_;
+}
+
+std::string PostgreSQLStatementRegistry::lastEvictionError() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return evictionError_;
+}
+
+void PostgreSQLStatementRegistry::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+}
 
 // PostgreSQLConnection implementation
-PostgreSQLConnection::PostgreSQLConnection() : conn_(nullptr) {}
+PostgreSQLConnection::PostgreSQLConnection() : conn_(nullptr), cursorCounter_(0) {}
 
 PostgreSQLConnection::~PostgreSQLConnection() {
     close();
 }
 
 bool PostgreSQLConnection::open(const std::string& connectionString) {
+    statements_.reset();
     conn_ = PQconnectdb(connectionString.c_str());
     
     if (PQstatus(conn_) != CONNECTION_OK) {
@@ -33,6 +148,7 @@ void PostgreSQLConnection::close() {
         PQfinish(conn_);
         conn_ = nullptr;
     }
+    statements_.reset();
 }
 
 bool PostgreSQLConnection::isOpen() const {
@@ -61,139 +177,118 @@ bool PostgreSQLConnection::execute(const std::string& sql) {
     return success;
 }
 
+std::shared_ptr<IResultSet> PostgreSQLConnection::openCursor(const std::string& sql, int fetchSize) {
+    std::string name = "hft_cursor_" + std::to_string(++cursorCounter_);
+    auto cursor = std::make_shared<PostgreSQLCursorResultSet>(this, name, fetchSize);
+    if (!cursor->open(sql)) {
+        return nullptr;
+    }
+    return cursor;
+}
+
 std::string PostgreSQLConnection::getLastError() const {
     return lastError_;
 }
 
 // PostgreSQLStatement implementation
 PostgreSQLStatement::PostgreSQLStatement(PostgreSQLConnection* conn, const std::string& sql)
-    : conn_(conn), sql_(sql), prepared_(false) {
-    std::ostringstream oss;
-    oss << "stmt_" << statementCounter++;
-    stmtName_ = oss.str();
-}
+    : conn_(conn), sql_(sql) {}
 
-PostgreSQLStatement::~PostgreSQLStatement() {
-    if (prepared_) {
-        std::string deallocate = "DEALLOCATE " + stmtName_;
-        PQexec(conn_->getHandle(), deallocate.c_str());
-    }
-}
-
-void PostgreSQLStatement::bindInt(int index, int32_t value) {
+void PostgreSQLStatement::ensureParam(int index) {
     if (index > static_cast<int>(paramValues_.size())) {
         paramValues_.resize(index);
+        paramBuffer_.resize(index * PARAM_SLOT_SIZE);
+        paramNulls_.resize(index, 1);
         paramLengths_.resize(index);
         paramFormats_.resize(index);
+        paramTypes_.resize(index);
     }
-    
-    paramValues_[index - 1] = std::to_string(value);
-    paramLengths_[index - 1] = 0;
-    paramFormats_[index - 1] = 0; // text format
+}
+
+char* PostgreSQLStatement::bindBinary(int index, Oid type, int length) {
+    ensureParam(index);
+    paramNulls_[index - 1] = 0;
+    paramLengths_[index - 1] = length;
+    paramFormats_[index - 1] = 1; // binary format
+    paramTypes_[index - 1] = type;
+    return &paramBuffer_[(index - 1) * PARAM_SLOT_SIZE];
+}
+
+void PostgreSQLStatement::bindInt(int index, int32_t value) {
+    PgBinary::writeInt32(bindBinary(index, PgOid::Int4, 4), value);
 }
 
 void PostgreSQLStatement::bindLong(int index, int64_t value) {
-    if (index > static_cast<int>(paramValues_.size())) {
-        paramValues_.resize(index);
-        paramLengths_.resize(index);
-        paramFormats_.resize(index);
-    }
-    
-    paramValues_[index - 1] = std::to_string(value);
-    paramLengths_[index - 1] = 0;
-    paramFormats_[index - 1] = 0;
+    PgBinary::writeInt64(bindBinary(index, PgOid::Int8, 8), value);
 }
 
 void PostgreSQLStatement::bindDouble(int index, double value) {
-    if (index > static_cast<int>(paramValues_.size())) {
-        paramValues_.resize(index);
-        paramLengths_.resize(index);
-        paramFormats_.resize(index);
-    }
-    
-    paramValues_[index - 1] = std::to_string(value);
-    paramLengths_[index - 1] = 0;
-    paramFormats_[index - 1] = 0;
+    PgBinary::writeFloat8(bindBinary(index, PgOid::Float8, 8), value);
 }
 
 void PostgreSQLStatement::bindString(int index, const std::string& value) {
-    if (index > static_cast<int>(paramValues_.size())) {
-        paramValues_.resize(index);
-        paramLengths_.resize(index);
-        paramFormats_.resize(index);
-    }
-    
+    ensureParam(index);
     paramValues_[index - 1] = value;
+    paramNulls_[index - 1] = 0;
     paramLengths_[index - 1] = 0;
-    paramFormats_[index - 1] = 0;
+    paramFormats_[index - 1] = 0; // text format
+    paramTypes_[index - 1] = 0;   // let the server infer the type
 }
 
 void PostgreSQLStatement::bindNull(int index) {
-    if (index > static_cast<int>(paramValues_.size())) {
-        paramValues_.resize(index);
-        paramLengths_.resize(index);
-        paramFormats_.resize(index);
-    }
-    
-    paramValues_[index - 1] = "";
+    ensureParam(index);
+    // Keep the parameter's current type so a NULL reuses the same prepared statement
+    paramNulls_[index - 1] = 1;
     paramLengths_[index - 1] = 0;
     paramFormats_[index - 1] = 0;
 }
 
-std::shared_ptr<IResultSet> PostgreSQLStatement::executeQuery() {
-    if (!prepared_) {
-        PGresult* prepResult = PQprepare(conn_->getHandle(), stmtName_.c_str(), 
-                                         sql_.c_str(), paramValues_.size(), nullptr);
-        
-        if (PQresultStatus(prepResult) != PGRES_COMMAND_OK) {
-            PQclear(prepResult);
-            return nullptr;
+PGresult* PostgreSQLStatement::execPrepared() {
+    if (!conn_->statements_.acquire(conn_->getHandle(), sql_, paramTypes_, stmtName_, conn_->lastError_)) {
+        return nullptr;
+    }
+
+    paramPointers_.resize(paramValues_.size());
+    for (size_t i = 0; i < paramValues_.size(); ++i) {
+        if (paramNulls_[i]) {
+            paramPointers_[i] = nullptr;
+        } else if (paramFormats_[i] == 1) {
+            paramPointers_[i] = &paramBuffer_[i * PARAM_SLOT_SIZE];
+        } else {
+            paramPointers_[i] = paramValues_[i].c_str();
         }
-        
-        PQclear(prepResult);
-        prepared_ = true;
     }
-    
-    paramPointers_.clear();
-    for (const auto& val : paramValues_) {
-        paramPointers_.push_back(val.c_str());
+
+    return PQexecPrepared(conn_->getHandle(), stmtName_.c_str(),
+                          static_cast<int>(paramPointers_.size()), paramPointers_.data(),
+                          paramLengths_.data(), paramFormats_.data(), 0);
+}
+
+std::shared_ptr<IResultSet> PostgreSQLStatement::executeQuery() {
+    PGresult* result = execPrepared();
+    if (!result) {
+        return nullptr;
     }
     
-    PGresult* result = PQexecPrepared(conn_->getHandle(), stmtName_.c_str(),
-                                      paramPointers_.size(), paramPointers_.data(),
-                                      paramLengths_.data(), paramFormats_.data(), 0);
-    
     if (PQresultStatus(result) != PGRES_TUPLES_OK) {
         PQclear(result);
         return nullptr;
     }
     
-    return std::make_shared<PostgreSQLResultSet>(result);
+    // The registry name identifies SQL plus parameter types, hence the result shape
+    if (!metadata_ || metadataName_ != stmtName_) {
+        metadata_ = PostgreSQLResultSet::describe(result);
+        metadataName_ = stmtName_;
+    }
+    return std::make_shared<PostgreSQLResultSet>(result, metadata_);
 }
 
 int PostgreSQLStatement::executeUpdate() {
-    if (!prepared_) {
-        PGresult* prepResult = PQprepare(conn_->getHandle(), stmtName_.c_str(), 
-                                         sql_.c_str(), paramValues_.size(), nullptr);
-        
-        if (PQresultStatus(prepResult) != PGRES_COMMAND_OK) {
-            PQclear(prepResult);
-            return -1;
-        }
-        
-        PQclear(prepResult);
-        prepared_ = true;
+    PGresult* result = execPrepared();
+    if (!result) {
+        return -1;
     }
     
-    paramPointers_.clear();
-    for (const auto& val : paramValues_) {
-        paramPointers_.push_back(val.c_str());
-    }
-    
-    PGresult* result = PQexecPrepared(conn_->getHandle(), stmtName_.c_str(),
-                                      paramPointers_.size(), paramPointers_.data(),
-                                      paramLengths_.data(), paramFormats_.data(), 0);
-    
     ExecStatusType status = PQresultStatus(result);
     int affected = 0;
     
@@ -208,15 +303,32 @@ int PostgreSQLStatement::executeUpdate() {
 
 void PostgreSQLStatement::reset() {
     paramValues_.clear();
+    paramBuffer_.clear();
+    paramNulls_.clear();
     paramLengths_.clear();
     paramFormats_.clear();
+    paramTypes_.clear();
     paramPointers_.clear();
 }
 
 // PostgreSQLResultSet implementation
-PostgreSQLResultSet::PostgreSQLResultSet(PGresult* result)
-    : result_(result), currentRow_(-1) {
+PostgreSQLResultSet::PostgreSQLResultSet(PGresult* result, std::shared_ptr<const ResultMetadata> metadata)
+    : result_(result), currentRow_(-1), metadata_(std::move(metadata)) {
     rowCount_ = PQntuples(result);
+    if (!metadata_) {
+        metadata_ = describe(result);
+    }
+}
+
+std::shared_ptr<const ResultMetadata> PostgreSQLResultSet::describe(const PGresult* result) {
+    int count = PQnfields(result);
+    std::vector<ColumnInfo> columns(count);
+    for (int i = 0; i < count; ++i) {
+        columns[i].name = PQfname(result, i);
+        columns[i].typeOid = PQftype(result, i);
+        columns[i].typeModifier = PQfmod(result, i);
+    }
+    return std::make_shared<const ResultMetadata>(std::move(columns));
 }
 
 PostgreSQLResultSet::~PostgreSQLResultSet() {
@@ -262,7 +374,137 @@ int PostgreSQLResultSet::getColumnCount() const {
 }
 
 std::string PostgreSQLResultSet::getColumnName(int index) const {
-    return PQfname(result_, index);
+    return metadata_->getColumn(index).name;
+}
+
+std::shared_ptr<const ResultMetadata> PostgreSQLResultSet::getMetadata() const {
+    return metadata_;
+}
+
+int PostgreSQLResultSet::findColumn(std::string_view name) const {
+    return metadata_->findColumn(name);
+}
+
+// PostgreSQLCursorResultSet implementation
+PostgreSQLCursorResultSet::PostgreSQLCursorResultSet(PostgreSQLConnection* conn, const std::string& cursorName,
+                                                     int fetchSize)
+    : conn_(conn), cursorName_(cursorName), fetchSize_(fetchSize > 0 ? fetchSize : 1),
+      declared_(false), exhausted_(false), ownsTransaction_(false) {}
+
+PostgreSQLCursorResultSet::~PostgreSQLCursorResultSet() {
+    close();
+}
+
+bool PostgreSQLCursorResultSet::open(const std::string& sql) {
+    if (!conn_->isOpen()) {
+        return false;
+    }
+    
+    if (PQtransactionStatus(conn_->getHandle()) == PQTRANS_IDLE) {
+        if (!conn_->execute("BEGIN")) {
+            return false;
+        }
+        ownsTransaction_ = true;
+    }
+    
+    if (!conn_->execute("DECLARE " + cursorName_ + " NO SCROLL CURSOR FOR " + sql)) {
+        close();
+        return false;
+    }
+    declared_ = true;
+    
+    // First page up front so column metadata is available before next()
+    if (!fetch()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool PostgreSQLCursorResultSet::fetch() {
+    std::string sql = "FETCH FORWARD " + std::to_string(fetchSize_) + " FROM " + cursorName_;
+    PGresult* result = PQexec(conn_->getHandle(), sql.c_str());
+    if (PQresultStatus(result) != PGRES_TUPLES_OK) {
+        conn_->lastError_ = PQerrorMessage(conn_->getHandle());
+        PQclear(result);
+        // The transaction is aborted; no further page can be read
+        exhausted_ = true;
+        page_.reset();
+        return false;
+    }
+    
+    if (PQntuples(result) < fetchSize_) {
+        exhausted_ = true;
+    }
+    page_ = std::make_unique<PostgreSQLResultSet>(result, metadata_);
+    if (!metadata_) {
+        metadata_ = page_->getMetadata();
+    }
+    return true;
+}
+
+void PostgreSQLCursorResultSet::close() {
+    page_.reset();
+    if (declared_) {
+        conn_->execute("CLOSE " + cursorName_);
+        declared_ = false;
+    }
+    if (ownsTransaction_) {
+        PGTransactionStatusType status = PQtransactionStatus(conn_->getHandle());
+        conn_->execute(status == PQTRANS_INERROR ? "ROLLBACK" : "COMMIT");
+        ownsTransaction_ = false;
+    }
+}
+
+bool PostgreSQLCursorResultSet::next() {
+    while (page_) {
+        if (page_->next()) {
+            return true;
+        }
+        if (exhausted_) {
+            return false;
+        }
+        if (!fetch()) {
+            throw std::runtime_error("PostgreSQLCursorResultSet::next: " + conn_->getLastError());
+        }
+    }
+    return false;
+}
+
+int32_t PostgreSQLCursorResultSet::getInt(int index) const {
+    return page_ ? page_->getInt(index) : 0;
+}
+
+int64_t PostgreSQLCursorResultSet::getLong(int index) const {
+    return page_ ? page_->getLong(index) : 0;
+}
+
+double PostgreSQLCursorResultSet::getDouble(int index) const {
+    return page_ ? page_->getDouble(index) : 0.0;
+}
+
+std::string PostgreSQLCursorResultSet::getString(int index) const {
+    return page_ ? page_->getString(index) : "";
+}
+
+bool PostgreSQLCursorResultSet::isNull(int index) const {
+    return page_ ? page_->isNull(index) : true;
+}
+
+int PostgreSQLCursorResultSet::getColumnCount() const {
+    return page_ ? page_->getColumnCount() : 0;
+}
+
+std::string PostgreSQLCursorResultSet::getColumnName(int index) const {
+    return page_ ? page_->getColumnName(index) : "";
+}
+
+std::shared_ptr<const ResultMetadata> PostgreSQLCursorResultSet::getMetadata() const {
+    return metadata_ ? metadata_ : std::make_shared<const ResultMetadata>(std::vector<ColumnInfo>());
+}
+
+int PostgreSQLCursorResultSet::findColumn(std::string_view name) const {
+    return metadata_ ? metadata_->findColumn(name) : -1;
 }
 
 // PostgreSQLTransaction implementation
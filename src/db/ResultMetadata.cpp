@@ -0,0 +1,20 @@
+#include "db/ResultMetadata.h"
+
+namespace hft {
+namespace db {
+
+ResultMetadata::ResultMetadata(std::vector<ColumnInfo> columns)
+    : columns_(std::move(columns)) {
+    index_.reserve(columns_.size());
+    for (int i = 0; i < static_cast<int>(columns_.size()); ++i) {
+        index_.emplace(columns_[i].name, i);
+    }
+}
+
+int ResultMetadata::findColumn(std::string_view name) const {
+    auto it = index_.find(name);
+    return it == index_.end() ? -1 : it->second;
+}
+
+} // namespace db
+} // namespace hft
@@ -252,6 +252,13 @@ void SybaseStatement::reset() {
 SybaseResultSet::SybaseResultSet(DBPROCESS* dbproc)
     : dbproc_(dbproc), hasRows_(false) {
     columnCount_ = dbnumcols(dbproc_);
+    std::vector<ColumnInfo> columns(columnCount_);
+    for (int i = 0; i < columnCount_; ++i) {
+        columns[i].name = dbcolname(dbproc_, i + 1);
+        columns[i].typeOid = static_cast<uint32_t>(dbcoltype(dbproc_, i + 1));
+        columns[i].typeModifier = dbcollen(dbproc_, i + 1);
+    }
+    metadata_ = std::make_shared<const ResultMetadata>(std::move(columns));
 }
 
 SybaseResultSet::~SybaseResultSet() {}
@@ -300,7 +307,15 @@ int SybaseResultSet::getColumnCount() const {
 }
 
 std::string SybaseResultSet::getColumnName(int index) const {
-    return dbcolname(dbproc_, index + 1);
+    return metadata_->getColumn(index).name;
+}
+
+std::shared_ptr<const ResultMetadata> SybaseResultSet::getMetadata() const {
+    return metadata_;
+}
+
+int SybaseResultSet::findColumn(std::string_view name) const {
+    return metadata_->findColumn(name);
 }
 
 // SybaseTransaction implementation
@@ -1,8 +1,14 @@
 #include "pg/PgConnection.hpp"
 #include "db/DBException.hpp"
 #include "pg/PgReader.hpp"
+#include "pg/PgStreamingReader.hpp"
 #include "pg/PgPreparedStatement.hpp"
 #include "pg/PgTransaction.hpp"
+#include "pg/PgPipeline.hpp"
+#include "pg/PgCopyWriter.hpp"
+#include "pg/PgCopyOutReader.hpp"
+#include "pg/PgCursorReader.hpp"
+#include "pg/PgNotificationListener.hpp"
 
 #ifdef WITH_POSTGRESQL
 #include <libpq-fe.h>
@@ -32,14 +38,25 @@ PgConnection::~PgConnection() {
 #endif
 }
 
+void PgConnection::requireNoPipeline(const char* caller) const {
+    if (_pipeline) {
+        throw DBException(DBErrorCode::INVALID_PARAMETER,
+                          std::string(caller) + ": not allowed while a pipeline is open on this connection");
+    }
+}
+
 std::unique_ptr<IDBReader>
 PgConnection::executeQuery(const std::string& sql) {
 #ifdef WITH_POSTGRESQL
     if (!_conn) {
         throw DBException("PgConnection::executeQuery: Connection is null");
     }
+    requireNoPipeline("PgConnection::executeQuery");
     
-    PGresult* res = PQexec(_conn, sql.c_str());
+    // PQexec only returns text; binary results need the extended protocol
+    PGresult* res = _binaryResults
+        ? PQexecParams(_conn, sql.c_str(), 0, nullptr, nullptr, nullptr, nullptr, 1)
+        : PQexec(_conn, sql.c_str());
     if (!res) {
         throw DBException("PgConnection::executeQuery: PQexec failed");
     }
@@ -58,6 +75,47 @@ PgConnection::executeQuery(const std::string& sql) {
 #endif
 }
 
+std::unique_ptr<IDBReader>
+PgConnection::executeStreamingQuery(const std::string& sql, FetchMode mode, int fetchSize) {
+#ifdef WITH_POSTGRESQL
+    requireNoPipeline("PgConnection::executeStreamingQuery");
+    if (mode == FetchMode::Buffered) {
+        return executeQuery(sql);
+    }
+    if (mode == FetchMode::Cursor) {
+        return std::make_unique<PgCursorReader>(this, sql, fetchSize);
+    }
+    if (!_conn) {
+        throw DBException("PgConnection::executeStreamingQuery: Connection is null");
+    }
+
+    if (!PQsendQueryParams(_conn, sql.c_str(), 0, nullptr, nullptr, nullptr, nullptr,
+                           _binaryResults ? 1 : 0)) {
+        throw DBException("PgConnection::executeStreamingQuery: " + std::string(PQerrorMessage(_conn)));
+    }
+    return std::make_unique<PgStreamingReader>(this, fetchSize);
+#else
+    (void)sql;
+    (void)mode;
+    (void)fetchSize;
+    throw DBException("PostgreSQL support not compiled in");
+#endif
+}
+
+std::unique_ptr<IDBReader>
+PgConnection::executeCopyOut(const std::string& query) {
+#ifdef WITH_POSTGRESQL
+    if (!_conn) {
+        throw DBException("PgConnection::executeCopyOut: Connection is null");
+    }
+    requireNoPipeline("PgConnection::executeCopyOut");
+    return std::make_unique<PgCopyOutReader>(this, query);
+#else
+    (void)query;
+    throw DBException("PostgreSQL support not compiled in");
+#endif
+}
+
 std::unique_ptr<IDBPreparedStatement>
 PgConnection::prepare(const std::string& sql) {
 #ifdef WITH_POSTGRESQL
@@ -71,12 +129,91 @@ PgConnection::prepare(const std::string& sql) {
 #endif
 }
 
+const std::string& PgConnection::preparedStatementName(const std::string& sql) {
+#ifdef WITH_POSTGRESQL
+    if (!_conn) {
+        throw DBException("PgConnection::preparedStatementName: Connection is null");
+    }
+
+    if (const std::string* existing = findPreparedStatement(sql)) {
+        return *existing;
+    }
+
+    const std::string& name = reservePreparedStatement(sql);
+    PGresult* res = PQprepare(_conn, name.c_str(), sql.c_str(), 0, nullptr);
+    if (!res || PQresultStatus(res) != PGRES_COMMAND_OK) {
+        std::string error = PQerrorMessage(_conn);
+        if (res) PQclear(res);
+        forgetPreparedStatement(sql);
+        throw DBException(DBErrorCode::QUERY_FAILED,
+                          "PgConnection::preparedStatementName: PQprepare failed: " + error, sql);
+    }
+    PQclear(res);
+
+    return name;
+#else
+    (void)sql;
+    throw DBException("PostgreSQL support not compiled in");
+#endif
+}
+
+const std::string* PgConnection::findPreparedStatement(const std::string& sql) const {
+    auto it = _preparedStatements.find(sql);
+    return it != _preparedStatements.end() ? &it->second : nullptr;
+}
+
+const std::string& PgConnection::reservePreparedStatement(const std::string& sql) {
+    std::string name = "hft_ps_" + std::to_string(++_preparedCounter);
+    return _preparedStatements.emplace(sql, std::move(name)).first->second;
+}
+
+void PgConnection::forgetPreparedStatement(const std::string& sql) {
+    _preparedStatements.erase(sql);
+}
+
+std::unique_ptr<IDBPipeline>
+PgConnection::beginPipeline() {
+#ifdef WITH_POSTGRESQL
+    if (!_conn) {
+        throw DBException("PgConnection::beginPipeline: Connection is null");
+    }
+    return std::make_unique<PgPipeline>(this);
+#else
+    throw DBException("PostgreSQL support not compiled in");
+#endif
+}
+
+std::unique_ptr<IDBBulkWriter>
+PgConnection::beginBulkInsert(const std::string& table, const std::vector<std::string>& columns) {
+#ifdef WITH_POSTGRESQL
+    if (!_conn) {
+        throw DBException("PgConnection::beginBulkInsert: Connection is null");
+    }
+    requireNoPipeline("PgConnection::beginBulkInsert");
+    return std::make_unique<PgCopyWriter>(this, table, columns, _copyBufferSize);
+#else
+    (void)table;
+    (void)columns;
+    throw DBException("PostgreSQL support not compiled in");
+#endif
+}
+
+std::unique_ptr<PgNotificationListener>
+PgConnection::createNotificationListener() {
+#ifdef WITH_POSTGRESQL
+    return std::make_unique<PgNotificationListener>(std::make_unique<PgConnection>(_conninfo));
+#else
+    throw DBException("PostgreSQL support not compiled in");
+#endif
+}
+
 std::unique_ptr<IDBTransaction>
 PgConnection::beginTransaction() {
 #ifdef WITH_POSTGRESQL
     if (!_conn) {
         throw DBException("PgConnection::beginTransaction: Connection is null");
     }
+    requireNoPipeline("PgConnection::beginTransaction");
     
     PGresult* res = PQexec(_conn, "BEGIN");
     if (!res || PQresultStatus(res) != PGRES_COMMAND_OK) {
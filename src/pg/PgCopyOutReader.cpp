@@ -0,0 +1,281 @@
+#include "pg/PgCopyOutReader.hpp"
+#include "pg/PgConnection.hpp"
+#include "pg/PgBinary.hpp"
+#include "db/DBException.hpp"
+#include <cstring>
+
+#ifdef WITH_POSTGRESQL
+#include <libpq-fe.h>
+#endif
+
+namespace {
+// "PGCOPY\n\377\r\n\0" followed by int32 flags and int32 header-extension length
+const char COPY_SIGNATURE[] = "PGCOPY\n\377\r\n";
+constexpr std::size_t COPY_HEADER_SIZE = sizeof(COPY_SIGNATURE) + 8;
+}
+
+const IDBValue& PgCopyOutRow::operator[](std::size_t idx) const {
+    if (idx >= _values.size()) {
+        throw DBException("PgCopyOutRow::operator[]: index out of range");
+    }
+    return _values[idx];
+}
+
+PgCopyOutReader::PgCopyOutReader(PgConnection* conn, const std::string& query)
+    : _conn(conn) {
+#ifdef WITH_POSTGRESQL
+    if (!_conn || !_conn->getConnection()) {
+        throw DBException("PgCopyOutReader: Connection is null");
+    }
+    describe(query);
+
+    std::string sql = "COPY (" + query + ") TO STDOUT (FORMAT binary)";
+    PGresult* res = PQexec(_conn->getConnection(), sql.c_str());
+    if (!res || PQresultStatus(res) != PGRES_COPY_OUT) {
+        std::string error = PQerrorMessage(_conn->getConnection());
+        if (res) PQclear(res);
+        _done = true;
+        throw DBException(DBErrorCode::QUERY_FAILED, "PgCopyOutReader: " + error, sql);
+    }
+    PQclear(res);
+#else
+    (void)query;
+    throw DBException("PostgreSQL support not compiled in");
+#endif
+}
+
+PgCopyOutReader::~PgCopyOutReader() {
+#ifdef WITH_POSTGRESQL
+    try {
+        cancel();
+    } catch (...) {
+        // Ignore errors in destructor
+    }
+#endif
+}
+
+void PgCopyOutReader::describe(const std::string& query) {
+#ifdef WITH_POSTGRESQL
+    // Binary COPY carries no type information; describe the query through
+    // the unnamed statement to learn each column's OID
+    PGconn* pg = _conn->getConnection();
+    PGresult* res = PQprepare(pg, "", query.c_str(), 0, nullptr);
+    if (!res || PQresultStatus(res) != PGRES_COMMAND_OK) {
+        std::string error = PQerrorMessage(pg);
+        if (res) PQclear(res);
+        throw DBException(DBErrorCode::QUERY_FAILED, "PgCopyOutReader: " + error, query);
+    }
+    PQclear(res);
+
+    res = PQdescribePrepared(pg, "");
+    if (!res || PQresultStatus(res) != PGRES_COMMAND_OK) {
+        std::string error = PQerrorMessage(pg);
+        if (res) PQclear(res);
+        throw DBException(DBErrorCode::QUERY_FAILED, "PgCopyOutReader: describe failed: " + error, query);
+    }
+    int numCols = PQnfields(res);
+    _row._values.reserve(numCols);
+    for (int col = 0; col < numCols; ++col) {
+        _row._values.emplace_back(std::string_view(), true, PQftype(res, col), true);
+    }
+    PQclear(res);
+#else
+    (void)query;
+#endif
+}
+
+bool PgCopyOutReader::next() {
+#ifdef WITH_POSTGRESQL
+    _hasRow = false;
+    if (_done) {
+        return false;
+    }
+
+    while (true) {
+        if (!_headerRead) {
+            if (parseHeader()) {
+                continue;
+            }
+        } else {
+            bool trailer = false;
+            if (parseRow(trailer)) {
+                if (trailer) {
+                    finishCopy();
+                    return false;
+                }
+                _hasRow = true;
+                return true;
+            }
+        }
+
+        if (!fill()) {
+            finishCopy();
+            throw DBException(DBErrorCode::RESULT_PROCESSING_FAILED,
+                              "PgCopyOutReader::next: COPY stream ended mid-row");
+        }
+    }
+#else
+    throw DBException("PostgreSQL support not compiled in");
+#endif
+}
+
+IDBRow& PgCopyOutReader::row() {
+    if (!_hasRow) {
+        throw DBException("PgCopyOutReader::row: no row");
+    }
+    return _row;
+}
+
+bool PgCopyOutReader::fill() {
+#ifdef WITH_POSTGRESQL
+    // Drop consumed bytes; the buffer keeps its capacity across rows
+    if (_offset > 0) {
+        _buffer.erase(0, _offset);
+        _offset = 0;
+    }
+
+    char* data = nullptr;
+    int len = PQgetCopyData(_conn->getConnection(), &data, 0);
+    if (len > 0) {
+        _buffer.append(data, static_cast<std::size_t>(len));
+        PQfreemem(data);
+        return true;
+    }
+    if (len == -1) {
+        _streamEnded = true;
+        return false;
+    }
+
+    std::string error = PQerrorMessage(_conn->getConnection());
+    drain();
+    _done = true;
+    throw DBException(DBErrorCode::QUERY_FAILED, "PgCopyOutReader: PQgetCopyData failed: " + error);
+#else
+    return false;
+#endif
+}
+
+bool PgCopyOutReader::parseHeader() {
+    std::size_t avail = _buffer.size() - _offset;
+    if (avail < COPY_HEADER_SIZE) {
+        return false;
+    }
+    const char* p = _buffer.data() + _offset;
+    if (std::memcmp(p, COPY_SIGNATURE, sizeof(COPY_SIGNATURE)) != 0) {
+        throw DBException(DBErrorCode::RESULT_PROCESSING_FAILED, "PgCopyOutReader: bad COPY signature");
+    }
+    auto extension = static_cast<std::size_t>(PgBinary::readInt32(p + sizeof(COPY_SIGNATURE) + 4));
+    if (avail < COPY_HEADER_SIZE + extension) {
+        return false;
+    }
+    _offset += COPY_HEADER_SIZE + extension;
+    _headerRead = true;
+    return true;
+}
+
+bool PgCopyOutReader::parseRow(bool& trailer) {
+    const char* base = _buffer.data();
+    std::size_t end = _buffer.size();
+    std::size_t pos = _offset;
+    if (end - pos < 2) {
+        return false;
+    }
+
+    int fieldCount = PgBinary::readInt16(base + pos);
+    pos += 2;
+    if (fieldCount == -1) {
+        _offset = pos;
+        trailer = true;
+        return true;
+    }
+    if (fieldCount != static_cast<int>(_row._values.size())) {
+        throw DBException(DBErrorCode::RESULT_PROCESSING_FAILED,
+                          "PgCopyOutReader: row has " + std::to_string(fieldCount) +
+                          " fields, expected " + std::to_string(_row._values.size()));
+    }
+
+    // Cells are pointed into _buffer as they are decoded; an incomplete row
+    // is decoded again once fill() has appended the rest of it
+    for (auto& value : _row._values) {
+        if (end - pos < 4) {
+            return false;
+        }
+        std::int32_t len = PgBinary::readInt32(base + pos);
+        pos += 4;
+        if (len < 0) {
+            value.assign(nullptr, 0, true);
+            continue;
+        }
+        if (end - pos < static_cast<std::size_t>(len)) {
+            return false;
+        }
+        value.assign(base + pos, static_cast<std::size_t>(len), false);
+        pos += static_cast<std::size_t>(len);
+    }
+    _offset = pos;
+    return true;
+}
+
+void PgCopyOutReader::finishCopy() {
+#ifdef WITH_POSTGRESQL
+    PGconn* pg = _conn->getConnection();
+    _done = true;
+
+    // The trailer is followed by the end of the copy stream
+    char* data = nullptr;
+    while (!_streamEnded) {
+        int len = PQgetCopyData(pg, &data, 0);
+        if (len > 0) {
+            PQfreemem(data);
+        } else {
+            _streamEnded = true;
+        }
+    }
+
+    std::string error;
+    while (PGresult* res = PQgetResult(pg)) {
+        if (PQresultStatus(res) != PGRES_COMMAND_OK && error.empty()) {
+            error = PQresultErrorMessage(res);
+        }
+        PQclear(res);
+    }
+    if (!error.empty()) {
+        throw DBException(DBErrorCode::QUERY_FAILED, "PgCopyOutReader: " + error);
+    }
+#endif
+}
+
+void PgCopyOutReader::cancel() {
+#ifdef WITH_POSTGRESQL
+    _hasRow = false;
+    if (_done || !_conn || !_conn->getConnection()) {
+        return;
+    }
+
+    PGcancel* cancel = PQgetCancel(_conn->getConnection());
+    if (cancel) {
+        char errbuf[256];
+        PQcancel(cancel, errbuf, sizeof(errbuf));
+        PQfreeCancel(cancel);
+    }
+    drain();
+    _done = true;
+#endif
+}
+
+void PgCopyOutReader::drain() {
+#ifdef WITH_POSTGRESQL
+    // The connection is only usable again once the copy stream and every
+    // result have been read
+    PGconn* pg = _conn->getConnection();
+    char* data = nullptr;
+    int len = 0;
+    while (!_streamEnded && (len = PQgetCopyData(pg, &data, 0)) > 0) {
+        PQfreemem(data);
+    }
+    _streamEnded = true;
+    while (PGresult* res = PQgetResult(pg)) {
+        PQclear(res);
+    }
+#endif
+}
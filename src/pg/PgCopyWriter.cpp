@@ -0,0 +1,184 @@
+#include "pg/PgCopyWriter.hpp"
+#include "pg/PgConnection.hpp"
+#include "pg/PgBinary.hpp"
+#include "db/DBException.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+#ifdef WITH_POSTGRESQL
+#include <libpq-fe.h>
+#endif
+
+namespace {
+// "PGCOPY\n\377\r\n\0", then int32 flags and int32 header-extension length
+const char COPY_SIGNATURE[] = "PGCOPY\n\377\r\n";
+}
+
+PgCopyWriter::PgCopyWriter(PgConnection* conn, const std::string& table,
+                           const std::vector<std::string>& columns,
+                           std::size_t bufferSize)
+    : _conn(conn), _bufferSize(bufferSize ? bufferSize : 1),
+      _columnCount(static_cast<int>(columns.size())) {
+#ifdef WITH_POSTGRESQL
+    if (!_conn || !_conn->getConnection()) {
+        throw DBException("PgCopyWriter: Connection is null");
+    }
+    if (columns.empty()) {
+        throw DBException(DBErrorCode::INVALID_PARAMETER, "PgCopyWriter: no columns");
+    }
+
+    std::string sql = "COPY " + table + " (";
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+        if (i > 0) sql += ", ";
+        sql += columns[i];
+    }
+    sql += ") FROM STDIN (FORMAT binary)";
+
+    PGresult* res = PQexec(_conn->getConnection(), sql.c_str());
+    if (!res || PQresultStatus(res) != PGRES_COPY_IN) {
+        std::string error = PQerrorMessage(_conn->getConnection());
+        if (res) PQclear(res);
+        throw DBException(DBErrorCode::QUERY_FAILED, "PgCopyWriter: " + error, sql);
+    }
+    PQclear(res);
+    _active = true;
+
+    _buffer.reserve(_bufferSize + 1024);
+    _buffer.append(COPY_SIGNATURE, sizeof(COPY_SIGNATURE));  // includes the trailing \0
+    PgBinary::appendInt32(_buffer, 0);  // flags
+    PgBinary::appendInt32(_buffer, 0);  // header extension length
+#else
+    (void)table;
+    throw DBException("PostgreSQL support not compiled in");
+#endif
+}
+
+PgCopyWriter::~PgCopyWriter() {
+    if (_active) {
+        try {
+            abort("bulk load abandoned by client");
+        } catch (...) {
+            // Ignore errors in destructor
+        }
+    }
+}
+
+void PgCopyWriter::startRow() {
+    if (!_active) throw DBException("PgCopyWriter::startRow: not active");
+    if (_inRow && _fieldsInRow != _columnCount) {
+        throw DBException(DBErrorCode::INVALID_PARAMETER,
+                          "PgCopyWriter::startRow: previous row has " + std::to_string(_fieldsInRow) +
+                          " of " + std::to_string(_columnCount) + " fields");
+    }
+    if (_buffer.size() >= _bufferSize) {
+        flush();
+    }
+    PgBinary::appendInt16(_buffer, static_cast<std::int16_t>(_columnCount));
+    _fieldsInRow = 0;
+    _inRow = true;
+}
+
+void PgCopyWriter::beginField() {
+    if (!_inRow) throw DBException("PgCopyWriter: write outside of a row");
+    if (_fieldsInRow >= _columnCount) {
+        throw DBException(DBErrorCode::INVALID_PARAMETER, "PgCopyWriter: too many fields in row");
+    }
+    ++_fieldsInRow;
+}
+
+void PgCopyWriter::writeNull() {
+    beginField();
+    PgBinary::appendInt32(_buffer, -1);
+}
+
+void PgCopyWriter::writeInt(int value) {
+    beginField();
+    PgBinary::appendInt32(_buffer, 4);
+    PgBinary::appendInt32(_buffer, value);
+}
+
+void PgCopyWriter::writeDouble(double value) {
+    beginField();
+    PgBinary::appendInt32(_buffer, 8);
+    PgBinary::appendFloat8(_buffer, value);
+}
+
+void PgCopyWriter::writeString(const std::string& value) {
+    // The field length is an int32; a wrapped length would corrupt the stream
+    if (value.size() > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max())) {
+        throw DBException(DBErrorCode::INVALID_PARAMETER,
+                          "PgCopyWriter::writeString: " + std::to_string(value.size()) +
+                          " bytes exceed the COPY field limit");
+    }
+    beginField();
+    PgBinary::appendInt32(_buffer, static_cast<std::int32_t>(value.size()));
+    _buffer.append(value);
+}
+
+void PgCopyWriter::flush() {
+#ifdef WITH_POSTGRESQL
+    if (_buffer.empty()) return;
+    // PQputCopyData takes an int length; a near-limit string field can
+    // push the buffer past it, so send in pieces
+    const std::size_t maxPiece = static_cast<std::size_t>(std::numeric_limits<int>::max());
+    for (std::size_t offset = 0; offset < _buffer.size(); offset += maxPiece) {
+        int piece = static_cast<int>(std::min(maxPiece, _buffer.size() - offset));
+        if (PQputCopyData(_conn->getConnection(), _buffer.data() + offset, piece) != 1) {
+            std::string error = PQerrorMessage(_conn->getConnection());
+            abort("PQputCopyData failed");
+            throw DBException(DBErrorCode::QUERY_FAILED, "PgCopyWriter: " + error);
+        }
+    }
+    _buffer.clear();
+#endif
+}
+
+long PgCopyWriter::finish() {
+#ifdef WITH_POSTGRESQL
+    if (!_active) throw DBException("PgCopyWriter::finish: not active");
+    if (_inRow && _fieldsInRow != _columnCount) {
+        throw DBException(DBErrorCode::INVALID_PARAMETER, "PgCopyWriter::finish: last row is incomplete");
+    }
+
+    PgBinary::appendInt16(_buffer, -1);  // file trailer
+    flush();
+
+    PGconn* pg = _conn->getConnection();
+    _active = false;
+    if (PQputCopyEnd(pg, nullptr) != 1) {
+        throw DBException(DBErrorCode::QUERY_FAILED, "PgCopyWriter::finish: " + std::string(PQerrorMessage(pg)));
+    }
+
+    long rows = 0;
+    std::string error;
+    while (PGresult* res = PQgetResult(pg)) {
+        if (PQresultStatus(res) == PGRES_COMMAND_OK) {
+            const char* count = PQcmdTuples(res);
+            rows = (count && *count) ? std::atol(count) : 0;
+        } else if (error.empty()) {
+            error = PQresultErrorMessage(res);
+        }
+        PQclear(res);
+    }
+    if (!error.empty()) {
+        throw DBException(DBErrorCode::QUERY_FAILED, "PgCopyWriter::finish: " + error);
+    }
+    return rows;
+#else
+    throw DBException("PostgreSQL support not compiled in");
+#endif
+}
+
+void PgCopyWriter::abort(const char* reason) {
+#ifdef WITH_POSTGRESQL
+    _active = false;
+    PGconn* pg = _conn->getConnection();
+    PQputCopyEnd(pg, reason);
+    while (PGresult* res = PQgetResult(pg)) {
+        PQclear(res);
+    }
+#else
+    (void)reason;
+#endif
+}
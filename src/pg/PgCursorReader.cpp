@@ -0,0 +1,137 @@
+#include "pg/PgCursorReader.hpp"
+#include "pg/PgConnection.hpp"
+#include "db/DBException.hpp"
+
+#ifdef WITH_POSTGRESQL
+#include <libpq-fe.h>
+#endif
+
+PgCursorReader::PgCursorReader(PgConnection* conn, const std::string& sql, int fetchSize)
+    : _conn(conn), _fetchSize(fetchSize > 0 ? fetchSize : 1) {
+#ifdef WITH_POSTGRESQL
+    if (!_conn || !_conn->getConnection()) {
+        throw DBException("PgCursorReader: Connection is null");
+    }
+
+    _cursorName = _conn->nextCursorName();
+    _fetchSql = "FETCH FORWARD " + std::to_string(_fetchSize) + " FROM " + _cursorName;
+
+    try {
+        if (PQtransactionStatus(_conn->getConnection()) == PQTRANS_IDLE) {
+            exec("BEGIN");
+            _ownsTransaction = true;
+        }
+        exec("DECLARE " + _cursorName + " NO SCROLL CURSOR FOR " + sql);
+        _declared = true;
+    } catch (...) {
+        try {
+            close();
+        } catch (...) {
+            // Report the original failure
+        }
+        throw;
+    }
+#else
+    (void)sql;
+    throw DBException("PostgreSQL support not compiled in");
+#endif
+}
+
+PgCursorReader::~PgCursorReader() {
+#ifdef WITH_POSTGRESQL
+    try {
+        close();
+    } catch (...) {
+        // Ignore errors in destructor
+    }
+#endif
+}
+
+bool PgCursorReader::next() {
+#ifdef WITH_POSTGRESQL
+    while (true) {
+        if (_result && ++_currentRow < _numRows) {
+            _row.setRow(_currentRow);
+            return true;
+        }
+        if (_exhausted || !_declared) {
+            return false;
+        }
+        fetch();
+    }
+#else
+    throw DBException("PostgreSQL support not compiled in");
+#endif
+}
+
+IDBRow& PgCursorReader::row() {
+    if (!_result || _currentRow < 0 || _currentRow >= _numRows) {
+        throw DBException("PgCursorReader::row: no row");
+    }
+    return _row;
+}
+
+void PgCursorReader::fetch() {
+#ifdef WITH_POSTGRESQL
+    if (_result) {
+        PQclear(_result);
+        _result = nullptr;
+    }
+
+    PGconn* pg = _conn->getConnection();
+    PGresult* res = PQexecParams(pg, _fetchSql.c_str(), 0, nullptr, nullptr, nullptr, nullptr,
+                                 _conn->binaryResults() ? 1 : 0);
+    if (!res || PQresultStatus(res) != PGRES_TUPLES_OK) {
+        std::string error = PQerrorMessage(pg);
+        if (res) PQclear(res);
+        _exhausted = true;
+        throw DBException(DBErrorCode::QUERY_FAILED, "PgCursorReader::next: " + error, _fetchSql);
+    }
+
+    _result = res;
+    _numRows = PQntuples(res);
+    _currentRow = -1;
+    _row.reset(res);
+    if (_numRows < _fetchSize) {
+        _exhausted = true;
+    }
+#endif
+}
+
+void PgCursorReader::close() {
+#ifdef WITH_POSTGRESQL
+    if (_result) {
+        PQclear(_result);
+        _result = nullptr;
+    }
+    _numRows = 0;
+    _exhausted = true;
+    if (!_conn || !_conn->getConnection()) {
+        return;
+    }
+
+    bool failed = PQtransactionStatus(_conn->getConnection()) == PQTRANS_INERROR;
+    if (_declared) {
+        _declared = false;
+        if (!failed) exec("CLOSE " + _cursorName);
+    }
+    if (_ownsTransaction) {
+        _ownsTransaction = false;
+        exec(failed ? "ROLLBACK" : "COMMIT");
+    }
+#endif
+}
+
+void PgCursorReader::exec(const std::string& sql) {
+#ifdef WITH_POSTGRESQL
+    PGresult* res = PQexec(_conn->getConnection(), sql.c_str());
+    if (!res || PQresultStatus(res) != PGRES_COMMAND_OK) {
+        std::string error = PQerrorMessage(_conn->getConnection());
+        if (res) PQclear(res);
+        throw DBException(DBErrorCode::QUERY_FAILED, "PgCursorReader: " + error, sql);
+    }
+    PQclear(res);
+#else
+    (void)sql;
+#endif
+}
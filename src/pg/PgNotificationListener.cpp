@@ -0,0 +1,172 @@
+#include "pg/PgNotificationListener.hpp"
+#include "pg/PgConnection.hpp"
+#include "db/DBException.hpp"
+#include "db/QueryResultCache.hpp"
+#include <cctype>
+
+#ifdef WITH_POSTGRESQL
+#include <libpq-fe.h>
+#endif
+
+PgNotificationListener::PgNotificationListener(std::unique_ptr<PgConnection> conn,
+                                               const std::string& invalidationChannel)
+    : _conn(std::move(conn)), _invalidationChannel(invalidationChannel) {
+#ifdef WITH_POSTGRESQL
+    if (!_conn || !_conn->getConnection()) {
+        throw DBException("PgNotificationListener: Connection is null");
+    }
+    // poll() must never wait on the socket
+    PQsetnonblocking(_conn->getConnection(), 1);
+#else
+    throw DBException("PostgreSQL support not compiled in");
+#endif
+}
+
+PgNotificationListener::~PgNotificationListener() = default;
+
+void PgNotificationListener::listen(const std::string& channel) {
+    execute("LISTEN " + quoteIdentifier(channel));
+}
+
+void PgNotificationListener::unlisten(const std::string& channel) {
+    execute("UNLISTEN " + quoteIdentifier(channel));
+    if (channel == _invalidationChannel) {
+        _listeningForInvalidation = false;
+    }
+}
+
+void PgNotificationListener::onNotify(const std::string& channel, NotifyCallback callback) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _channelCallbacks[channel].push_back(std::move(callback));
+}
+
+void PgNotificationListener::onInvalidate(const std::string& table, InvalidateCallback callback) {
+    if (!_listeningForInvalidation) {
+        listen(_invalidationChannel);
+        _listeningForInvalidation = true;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    _tableCallbacks[table].push_back(std::move(callback));
+}
+
+void PgNotificationListener::invalidateQueryCache(const std::string& table) {
+    onInvalidate(table, [](const std::string& changed) {
+        QueryResultCache::instance().invalidateTable(changed);
+    });
+}
+
+int PgNotificationListener::poll() {
+#ifdef WITH_POSTGRESQL
+    PGconn* pg = _conn->getConnection();
+    if (!PQconsumeInput(pg)) {
+        throw DBException(DBErrorCode::CONNECTION_FAILED,
+                          "PgNotificationListener::poll: " + std::string(PQerrorMessage(pg)));
+    }
+
+    int received = 0;
+    while (PGnotify* notify = PQnotifies(pg)) {
+        std::string channel = notify->relname ? notify->relname : "";
+        std::string payload = notify->extra ? notify->extra : "";
+        PQfreemem(notify);
+        ++received;
+
+        // Copy the handlers so callbacks may register more without deadlocking
+        std::vector<NotifyCallback> channelCallbacks;
+        std::vector<InvalidateCallback> tableCallbacks;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = _channelCallbacks.find(channel);
+            if (it != _channelCallbacks.end()) {
+                channelCallbacks = it->second;
+            }
+            if (channel == _invalidationChannel) {
+                auto tableIt = _tableCallbacks.find(payload);
+                if (tableIt != _tableCallbacks.end()) {
+                    tableCallbacks = tableIt->second;
+                }
+            }
+        }
+        for (auto& callback : channelCallbacks) {
+            callback(channel, payload);
+        }
+        for (auto& callback : tableCallbacks) {
+            callback(payload);
+        }
+    }
+    return received;
+#else
+    return 0;
+#endif
+}
+
+int PgNotificationListener::socket() const {
+#ifdef WITH_POSTGRESQL
+    return PQsocket(_conn->getConnection());
+#else
+    return -1;
+#endif
+}
+
+void PgNotificationListener::installInvalidationTrigger(const std::string& table) {
+    execute(invalidationTriggerSql(table, _invalidationChannel));
+}
+
+std::string PgNotificationListener::invalidationTriggerSql(const std::string& table, const std::string& channel) {
+    // Trigger names cannot carry a schema prefix or other punctuation
+    std::string triggerName = "hft_invalidate_";
+    for (char c : table) {
+        triggerName += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+    }
+
+    std::string quotedChannel = "'";
+    for (char c : channel) {
+        quotedChannel += c;
+        if (c == '\'') quotedChannel += '\'';
+    }
+    quotedChannel += "'";
+
+    return
+        "CREATE OR REPLACE FUNCTION hft_notify_invalidate() RETURNS trigger AS $hft$\n"
+        "BEGIN\n"
+        "    PERFORM pg_notify(TG_ARGV[0], TG_TABLE_NAME);\n"
+        "    RETURN NULL;\n"
+        "END;\n"
+        "$hft$ LANGUAGE plpgsql;\n"
+        "DROP TRIGGER IF EXISTS " + triggerName + " ON " + table + ";\n"
+        "CREATE TRIGGER " + triggerName + "\n"
+        "    AFTER INSERT OR UPDATE OR DELETE OR TRUNCATE ON " + table + "\n"
+        "    FOR EACH STATEMENT EXECUTE PROCEDURE hft_notify_invalidate(" + quotedChannel + ");\n";
+}
+
+void PgNotificationListener::execute(const std::string& sql) {
+#ifdef WITH_POSTGRESQL
+    // Blocking commands are fine here: they run only while (un)subscribing
+    PGconn* pg = _conn->getConnection();
+    PQsetnonblocking(pg, 0);
+    PGresult* res = PQexec(pg, sql.c_str());
+    PQsetnonblocking(pg, 1);
+    if (!res || PQresultStatus(res) != PGRES_COMMAND_OK) {
+        std::string error = PQerrorMessage(pg);
+        if (res) PQclear(res);
+        throw DBException(DBErrorCode::QUERY_FAILED, "PgNotificationListener: " + error, sql);
+    }
+    PQclear(res);
+#else
+    (void)sql;
+#endif
+}
+
+std::string PgNotificationListener::quoteIdentifier(const std::string& name) {
+#ifdef WITH_POSTGRESQL
+    char* quoted = PQescapeIdentifier(_conn->getConnection(), name.c_str(), name.size());
+    if (!quoted) {
+        throw DBException(DBErrorCode::INVALID_PARAMETER,
+                          "PgNotificationListener: invalid channel name '" + name + "'");
+    }
+    std::string result(quoted);
+    PQfreemem(quoted);
+    return result;
+#else
+    return name;
+#endif
+}
@@ -0,0 +1,172 @@
+#include "pg/PgPipeline.hpp"
+#include "pg/PgConnection.hpp"
+#include "db/DBException.hpp"
+#include <cstdlib>
+
+#ifdef WITH_POSTGRESQL
+#include <libpq-fe.h>
+#endif
+
+PgPipeline::PgPipeline(PgConnection* conn, std::size_t maxPending)
+    : _conn(conn), _maxPending(maxPending ? maxPending : 1) {
+#ifdef WITH_POSTGRESQL
+    if (!_conn || !_conn->getConnection()) {
+        throw DBException("PgPipeline: Connection is null");
+    }
+    if (_conn->_pipeline) {
+        throw DBException(DBErrorCode::INVALID_PARAMETER, "PgPipeline: a pipeline is already open on this connection");
+    }
+    if (!PQenterPipelineMode(_conn->getConnection())) {
+        throw DBException("PgPipeline: PQenterPipelineMode failed: " +
+                          std::string(PQerrorMessage(_conn->getConnection())));
+    }
+    _conn->_pipeline = this;
+#else
+    throw DBException("PostgreSQL support not compiled in");
+#endif
+}
+
+PgPipeline::~PgPipeline() {
+#ifdef WITH_POSTGRESQL
+    try {
+        if (!_inFlight.empty()) {
+            collect();
+        }
+    } catch (...) {
+        // Ignore errors in destructor
+    }
+    PGconn* pg = _conn ? _conn->getConnection() : nullptr;
+    if (pg) {
+        // A failed collect() can leave results unread, and PQexitPipelineMode
+        // refuses while any are pending. Drain until the queue is idle (two
+        // consecutive nulls) so the connection never stays in pipeline mode.
+        while (!PQexitPipelineMode(pg) && PQstatus(pg) == CONNECTION_OK) {
+            PGresult* res = PQgetResult(pg);
+            if (!res) {
+                res = PQgetResult(pg);
+                if (!res) break;
+            }
+            PQclear(res);
+        }
+    }
+    if (_conn) {
+        _conn->_pipeline = nullptr;
+    }
+#endif
+}
+
+std::size_t PgPipeline::pending() const {
+    return _queued;
+}
+
+void PgPipeline::enqueue(const std::string& sql, const std::vector<std::string>& params, bool serverPrepare,
+                         const std::vector<int>& formats) {
+#ifdef WITH_POSTGRESQL
+    PGconn* pg = _conn->getConnection();
+
+    std::vector<const char*> values;
+    std::vector<int> lengths;
+    values.reserve(params.size());
+    lengths.reserve(params.size());
+    for (const auto& param : params) {
+        values.push_back(param.c_str());
+        lengths.push_back(static_cast<int>(param.size()));
+    }
+    const int* paramFormats = formats.empty() ? nullptr : formats.data();
+
+    int ok = 0;
+    if (serverPrepare) {
+        const std::string* name = _conn->findPreparedStatement(sql);
+        if (!name) {
+            name = &_conn->reservePreparedStatement(sql);
+            if (!PQsendPrepare(pg, name->c_str(), sql.c_str(), 0, nullptr)) {
+                _conn->forgetPreparedStatement(sql);
+                throw DBException("PgPipeline::enqueue: PQsendPrepare failed: " + std::string(PQerrorMessage(pg)));
+            }
+            _inFlight.push_back({true, sql});
+        }
+        ok = PQsendQueryPrepared(pg, name->c_str(), static_cast<int>(values.size()),
+                                 values.data(), lengths.data(), paramFormats, 0);
+    } else {
+        ok = PQsendQueryParams(pg, sql.c_str(), static_cast<int>(values.size()), nullptr,
+                               values.data(), lengths.data(), paramFormats, 0);
+    }
+    if (!ok) {
+        throw DBException("PgPipeline::enqueue: " + std::string(PQerrorMessage(pg)));
+    }
+
+    _inFlight.push_back({false, {}});
+    if (++_queued % _maxPending == 0) {
+        collect();
+    }
+#else
+    (void)sql;
+    (void)params;
+    (void)serverPrepare;
+    (void)formats;
+    throw DBException("PostgreSQL support not compiled in");
+#endif
+}
+
+std::vector<DBPipelineResult> PgPipeline::sync() {
+    if (!_inFlight.empty()) {
+        collect();
+    }
+    _queued = 0;
+    std::vector<DBPipelineResult> results;
+    results.swap(_results);
+    return results;
+}
+
+void PgPipeline::collect() {
+#ifdef WITH_POSTGRESQL
+    PGconn* pg = _conn->getConnection();
+    if (!PQpipelineSync(pg)) {
+        throw DBException("PgPipeline::sync: PQpipelineSync failed: " + std::string(PQerrorMessage(pg)));
+    }
+
+    while (!_inFlight.empty()) {
+        Pending cmd = std::move(_inFlight.front());
+        _inFlight.pop_front();
+
+        PGresult* res = PQgetResult(pg);
+        if (!res) {
+            throw DBException(DBErrorCode::RESULT_PROCESSING_FAILED, "PgPipeline::sync: missing result");
+        }
+
+        ExecStatusType status = PQresultStatus(res);
+        bool ok = status == PGRES_COMMAND_OK || status == PGRES_TUPLES_OK;
+
+        if (cmd.isPrepare) {
+            if (!ok) {
+                _conn->forgetPreparedStatement(cmd.sql);
+            }
+        } else {
+            DBPipelineResult result;
+            result.ok = ok;
+            if (ok) {
+                const char* rows = PQcmdTuples(res);
+                result.affectedRows = (rows && *rows) ? std::atol(rows) : 0;
+            } else if (status == PGRES_PIPELINE_ABORTED) {
+                result.error = "skipped: an earlier statement in the pipeline failed";
+            } else {
+                result.error = PQresultErrorMessage(res);
+            }
+            _results.push_back(std::move(result));
+        }
+        PQclear(res);
+
+        // Each command's results are terminated by a null result
+        while ((res = PQgetResult(pg)) != nullptr) {
+            PQclear(res);
+        }
+    }
+
+    PGresult* syncRes = PQgetResult(pg);
+    if (!syncRes || PQresultStatus(syncRes) != PGRES_PIPELINE_SYNC) {
+        if (syncRes) PQclear(syncRes);
+        throw DBException(DBErrorCode::RESULT_PROCESSING_FAILED, "PgPipeline::sync: missing sync point");
+    }
+    PQclear(syncRes);
+#endif
+}
@@ -1,66 +1,192 @@
 #include "pg/PgPreparedStatement.hpp"
 #include "db/DBException.hpp"
 #include "pg/PgReader.hpp"
+#include "pg/PgStreamingReader.hpp"
 #include "pg/PgConnection.hpp"
+#include "pg/PgPipeline.hpp"
+#include "pg/PgBinary.hpp"
 
 #ifdef WITH_POSTGRESQL
 #include <libpq-fe.h>
 #endif
 
 PgPreparedStatement::PgPreparedStatement(std::string sql, PgConnection* conn)
-    : _sql(std::move(sql)), _conn(conn) {}
+    : _sql(std::move(sql)), _conn(conn),
+      _binaryResults(conn && conn->binaryResults()),
+      _serverPrepare(conn && conn->serverPrepare()) {}
 
 PgPreparedStatement::~PgPreparedStatement() = default;
 
-void PgPreparedStatement::bindInt(int index, int value) {
-    if (index <= 0) throw DBException("PgPreparedStatement::bindInt: index <= 0");
-    if (static_cast<std::size_t>(index) > _params.size())
+std::string& PgPreparedStatement::param(int index, int format, const char* caller) {
+    if (index <= 0) throw DBException(std::string(caller) + ": index <= 0");
+    if (static_cast<std::size_t>(index) > _params.size()) {
         _params.resize(index);
-    _params[index - 1] = std::to_string(value);
+        _formats.resize(index, 0);
+    }
+    _formats[index - 1] = format;
+    _hasBinary = _hasBinary || format == 1;
+    return _params[index - 1];
+}
+
+void PgPreparedStatement::bindInt(int index, int value) {
+    param(index, 0, "PgPreparedStatement::bindInt") = std::to_string(value);
 }
 
 void PgPreparedStatement::bindDouble(int index, double value) {
-    if (index <= 0) throw DBException("PgPreparedStatement::bindDouble: index <= 0");
-    if (static_cast<std::size_t>(index) > _params.size())
-        _params.resize(index);
-    _params[index - 1] = std::to_string(value);
+    param(index, 0, "PgPreparedStatement::bindDouble") = std::to_string(value);
 }
 
 void PgPreparedStatement::bindString(int index, const std::string& value) {
-    if (index <= 0) throw DBException("PgPreparedStatement::bindString: index <= 0");
-    if (static_cast<std::size_t>(index) > _params.size())
-        _params.resize(index);
-    _params[index - 1] = value;
+    param(index, 0, "PgPreparedStatement::bindString") = value;
 }
 
-std::unique_ptr<IDBReader> PgPreparedStatement::executeQuery() {
+void PgPreparedStatement::bindIntArray(int index, const std::vector<int>& values) {
+    std::string& out = param(index, 1, "PgPreparedStatement::bindIntArray");
+    out.clear();
+    out.reserve(20 + values.size() * 8);
+    PgBinary::appendArrayHeader(out, PgOid::Int4, static_cast<std::int32_t>(values.size()));
+    for (int value : values) {
+        PgBinary::appendInt32(out, 4);
+        PgBinary::appendInt32(out, value);
+    }
+}
+
+void PgPreparedStatement::bindDoubleArray(int index, const std::vector<double>& values) {
+    std::string& out = param(index, 1, "PgPreparedStatement::bindDoubleArray");
+    out.clear();
+    out.reserve(20 + values.size() * 12);
+    PgBinary::appendArrayHeader(out, PgOid::Float8, static_cast<std::int32_t>(values.size()));
+    for (double value : values) {
+        PgBinary::appendInt32(out, 8);
+        PgBinary::appendFloat8(out, value);
+    }
+}
+
+void PgPreparedStatement::bindStringArray(int index, const std::vector<std::string>& values) {
+    std::size_t bytes = 20;
+    for (const auto& value : values) bytes += 4 + value.size();
+
+    std::string& out = param(index, 1, "PgPreparedStatement::bindStringArray");
+    out.clear();
+    out.reserve(bytes);
+    PgBinary::appendArrayHeader(out, PgOid::Text, static_cast<std::int32_t>(values.size()));
+    for (const auto& value : values) {
+        PgBinary::appendInt32(out, static_cast<std::int32_t>(value.size()));
+        out.append(value);
+    }
+}
+
+pg_result* PgPreparedStatement::execute(const char* caller, int resultFormat) {
 #ifdef WITH_POSTGRESQL
     if (!_conn || !_conn->getConnection()) {
-        throw DBException("PgPreparedStatement::executeQuery: Connection is null");
+        throw DBException(std::string(caller) + ": Connection is null");
     }
     
-    // Convert params to C-style arrays for libpq
-    std::vector<const char*> paramValues;
-    paramValues.reserve(_params.size());
-    for (const auto& param : _params) {
-        paramValues.push_back(param.c_str());
-    }
+    std::vector<const char*> values = paramValues();
+    std::vector<int> lengths = paramLengths();
+    const int* formats = _hasBinary ? _formats.data() : nullptr;
     
-    PGresult* res = PQexecParams(
-        _conn->getConnection(),
-        _sql.c_str(),
-        static_cast<int>(_params.size()),
-        nullptr,  // let PostgreSQL infer types
-        paramValues.data(),
-        nullptr,  // text format
-        nullptr,  // text format
-        0         // text format results
-    );
+    PGresult* res = nullptr;
+    if (_serverPrepare) {
+        const std::string& name = _conn->preparedStatementName(_sql);
+        res = PQexecPrepared(
+            _conn->getConnection(),
+            name.c_str(),
+            static_cast<int>(_params.size()),
+            values.data(),
+            lengths.data(),
+            formats,  // null: all text
+            resultFormat
+        );
+    } else {
+        res = PQexecParams(
+            _conn->getConnection(),
+            _sql.c_str(),
+            static_cast<int>(_params.size()),
+            nullptr,  // let PostgreSQL infer types
+            values.data(),
+            lengths.data(),
+            formats,  // null: all text
+            resultFormat
+        );
+    }
     
     if (!res) {
-        throw DBException("PgPreparedStatement::executeQuery: PQexecParams failed");
+        throw DBException(std::string(caller) + (_serverPrepare ? ": PQexecPrepared failed" : ": PQexecParams failed"));
+    }
+    return res;
+#else
+    (void)caller;
+    (void)resultFormat;
+    throw DBException("PostgreSQL support not compiled in");
+#endif
+}
+
+void PgPreparedStatement::send(const char* caller, int resultFormat) {
+#ifdef WITH_POSTGRESQL
+    if (!_conn || !_conn->getConnection()) {
+        throw DBException(std::string(caller) + ": Connection is null");
+    }
+    
+    std::vector<const char*> values = paramValues();
+    std::vector<int> lengths = paramLengths();
+    const int* formats = _hasBinary ? _formats.data() : nullptr;
+    
+    int ok = 0;
+    if (_serverPrepare) {
+        const std::string& name = _conn->preparedStatementName(_sql);
+        ok = PQsendQueryPrepared(_conn->getConnection(), name.c_str(),
+                                 static_cast<int>(_params.size()), values.data(),
+                                 lengths.data(), formats, resultFormat);
+    } else {
+        ok = PQsendQueryParams(_conn->getConnection(), _sql.c_str(),
+                               static_cast<int>(_params.size()), nullptr, values.data(),
+                               lengths.data(), formats, resultFormat);
     }
     
+    if (!ok) {
+        throw DBException(std::string(caller) + ": " + PQerrorMessage(_conn->getConnection()));
+    }
+#else
+    (void)caller;
+    (void)resultFormat;
+    throw DBException("PostgreSQL support not compiled in");
+#endif
+}
+
+std::vector<const char*> PgPreparedStatement::paramValues() const {
+    // Convert params to C-style arrays for libpq
+    std::vector<const char*> values;
+    values.reserve(_params.size());
+    for (const auto& param : _params) {
+        values.push_back(param.c_str());
+    }
+    return values;
+}
+
+std::vector<int> PgPreparedStatement::paramLengths() const {
+    // Only consulted by libpq for binary parameters
+    std::vector<int> lengths;
+    lengths.reserve(_params.size());
+    for (const auto& value : _params) {
+        lengths.push_back(static_cast<int>(value.size()));
+    }
+    return lengths;
+}
+
+std::unique_ptr<IDBReader> PgPreparedStatement::executeStreamingQuery(int chunkSize) {
+    send("PgPreparedStatement::executeStreamingQuery", _binaryResults ? 1 : 0);
+    return std::make_unique<PgStreamingReader>(_conn, chunkSize);
+}
+
+std::unique_ptr<IDBReader> PgPreparedStatement::executeQuery() {
+#ifdef WITH_POSTGRESQL
+    if (_conn && _conn->activePipeline()) {
+        throw DBException(DBErrorCode::INVALID_PARAMETER,
+                          "PgPreparedStatement::executeQuery: not supported while a pipeline is open");
+    }
+    PGresult* res = execute("PgPreparedStatement::executeQuery", _binaryResults ? 1 : 0);
+    
     ExecStatusType status = PQresultStatus(res);
     if (status != PGRES_TUPLES_OK) {
         std::string error = PQerrorMessage(_conn->getConnection());
@@ -76,31 +202,13 @@ std::unique_ptr<IDBReader> PgPreparedStatement::executeQuery() {
 
 void PgPreparedStatement::executeUpdate() {
 #ifdef WITH_POSTGRESQL
-    if (!_conn || !_conn->getConnection()) {
-        throw DBException("PgPreparedStatement::executeUpdate: Connection is null");
-    }
-    
-    // Convert params to C-style arrays for libpq
-    std::vector<const char*> paramValues;
-    paramValues.reserve(_params.size());
-    for (const auto& param : _params) {
-        paramValues.push_back(param.c_str());
-    }
-    
-    PGresult* res = PQexecParams(
-        _conn->getConnection(),
-        _sql.c_str(),
-        static_cast<int>(_params.size()),
-        nullptr,  // let PostgreSQL infer types
-        paramValues.data(),
-        nullptr,  // text format
-        nullptr,  // text format
-        0         // text format results
-    );
-    
-    if (!res) {
-        throw DBException("PgPreparedStatement::executeUpdate: PQexecParams failed");
+    // Inside a pipeline the result is collected at the next sync
+    if (_conn && _conn->activePipeline()) {
+        _conn->activePipeline()->enqueue(_sql, _params, _serverPrepare,
+                                         _hasBinary ? _formats : std::vector<int>());
+        return;
     }
+    PGresult* res = execute("PgPreparedStatement::executeUpdate", 0);
     
     ExecStatusType status = PQresultStatus(res);
     if (status != PGRES_COMMAND_OK) {
@@ -11,6 +11,7 @@ PgReader::PgReader(PGresult* result)
 #ifdef WITH_POSTGRESQL
     if (_result) {
         _numRows = PQntuples(_result);
+        _row.reset(_result);
     }
 #else
     (void)result;
@@ -33,7 +34,7 @@ bool PgReader::next() {
     if (_currentRow >= _numRows) {
         return false;
     }
-    _row = std::make_unique<PgRow>(_result, _currentRow);
+    _row.setRow(_currentRow);
     return true;
 #else
     throw DBException("PostgreSQL support not compiled in");
@@ -41,8 +42,8 @@ bool PgReader::next() {
 }
 
 IDBRow& PgReader::row() {
-    if (!_row) {
+    if (_currentRow < 0 || _currentRow >= _numRows) {
         throw DBException("PgReader::row: no row");
     }
-    return *_row;
+    return _row;
 }
@@ -6,32 +6,43 @@
 #include <libpq-fe.h>
 #endif
 
-PgRow::PgRow(PGresult* result, int rowNum) {
+PgRow::~PgRow() = default;
+
+void PgRow::reset(PGresult* result) {
 #ifdef WITH_POSTGRESQL
     if (!result) {
         throw DBException("PgRow: result is null");
     }
-    
+    _result = result;
+
     int numCols = PQnfields(result);
-    _values.reserve(numCols);
-    
+    _values.resize(numCols);
     for (int col = 0; col < numCols; ++col) {
-        bool isNull = PQgetisnull(result, rowNum, col) != 0;
-        std::string value;
-        if (!isNull) {
-            char* val = PQgetvalue(result, rowNum, col);
-            value = val ? val : "";
-        }
-        _values.push_back(std::make_unique<PgValue>(value, isNull));
+        _values[col].setType(PQftype(result, col), PQfformat(result, col) == 1);
     }
 #else
     (void)result;
-    (void)rowNum;
     throw DBException("PostgreSQL support not compiled in");
 #endif
 }
 
-PgRow::~PgRow() = default;
+void PgRow::setRow(int rowNum) {
+#ifdef WITH_POSTGRESQL
+    if (!_result) {
+        throw DBException("PgRow: result is null");
+    }
+    int numCols = static_cast<int>(_values.size());
+    for (int col = 0; col < numCols; ++col) {
+        // Binary cells may contain NUL bytes, so view by length
+        _values[col].assign(PQgetvalue(_result, rowNum, col),
+                            static_cast<std::size_t>(PQgetlength(_result, rowNum, col)),
+                            PQgetisnull(_result, rowNum, col) != 0);
+    }
+#else
+    (void)rowNum;
+    throw DBException("PostgreSQL support not compiled in");
+#endif
+}
 
 std::size_t PgRow::columnCount() const {
     return _values.size();
@@ -41,5 +52,5 @@ const IDBValue& PgRow::operator[](std::size_t idx) const {
     if (idx >= _values.size()) {
         throw DBException("PgRow::operator[]: index out of range");
     }
-    return *_values[idx];
+    return _values[idx];
 }
@@ -0,0 +1,141 @@
+#include "pg/PgStreamingReader.hpp"
+#include "pg/PgConnection.hpp"
+#include "pg/PgRow.hpp"
+#include "db/DBException.hpp"
+
+#ifdef WITH_POSTGRESQL
+#include <libpq-fe.h>
+#endif
+
+PgStreamingReader::PgStreamingReader(PgConnection* conn, int chunkSize)
+    : _conn(conn) {
+#ifdef WITH_POSTGRESQL
+    if (!_conn || !_conn->getConnection()) {
+        throw DBException("PgStreamingReader: Connection is null");
+    }
+
+    int ok = 0;
+#ifdef LIBPQ_HAS_CHUNK_MODE
+    if (chunkSize > 1) {
+        ok = PQsetChunkedRowsMode(_conn->getConnection(), chunkSize);
+    } else {
+        ok = PQsetSingleRowMode(_conn->getConnection());
+    }
+#else
+    (void)chunkSize;
+    ok = PQsetSingleRowMode(_conn->getConnection());
+#endif
+    if (!ok) {
+        drain();
+        _done = true;
+        throw DBException(DBErrorCode::QUERY_FAILED,
+                          "PgStreamingReader: cannot switch to single-row mode");
+    }
+#else
+    (void)chunkSize;
+    throw DBException("PostgreSQL support not compiled in");
+#endif
+}
+
+PgStreamingReader::~PgStreamingReader() {
+#ifdef WITH_POSTGRESQL
+    try {
+        cancel();
+    } catch (...) {
+        // Ignore errors in destructor
+    }
+#endif
+}
+
+bool PgStreamingReader::next() {
+#ifdef WITH_POSTGRESQL
+    _hasRow = false;
+    while (true) {
+        if (_result && ++_currentRow < _numRows) {
+            _row.setRow(_currentRow);
+            _hasRow = true;
+            return true;
+        }
+        if (_result) {
+            PQclear(_result);
+            _result = nullptr;
+        }
+        if (_done) {
+            return false;
+        }
+
+        PGresult* res = PQgetResult(_conn->getConnection());
+        if (!res) {
+            _done = true;
+            return false;
+        }
+
+        ExecStatusType status = PQresultStatus(res);
+        if (status == PGRES_SINGLE_TUPLE
+#ifdef LIBPQ_HAS_CHUNK_MODE
+            || status == PGRES_TUPLES_CHUNK
+#endif
+            ) {
+            _result = res;
+            _numRows = PQntuples(res);
+            _currentRow = -1;
+            _row.reset(res);
+            continue;
+        }
+
+        if (status == PGRES_TUPLES_OK) {
+            // Zero-row terminator of the result set
+            PQclear(res);
+            drain();
+            _done = true;
+            return false;
+        }
+
+        std::string error = PQresultErrorMessage(res);
+        PQclear(res);
+        drain();
+        _done = true;
+        throw DBException(DBErrorCode::QUERY_FAILED, "PgStreamingReader::next: " + error);
+    }
+#else
+    throw DBException("PostgreSQL support not compiled in");
+#endif
+}
+
+IDBRow& PgStreamingReader::row() {
+    if (!_hasRow) {
+        throw DBException("PgStreamingReader::row: no row");
+    }
+    return _row;
+}
+
+void PgStreamingReader::cancel() {
+#ifdef WITH_POSTGRESQL
+    _hasRow = false;
+    if (_result) {
+        PQclear(_result);
+        _result = nullptr;
+    }
+    if (_done || !_conn || !_conn->getConnection()) {
+        return;
+    }
+
+    PGcancel* cancel = PQgetCancel(_conn->getConnection());
+    if (cancel) {
+        char errbuf[256];
+        PQcancel(cancel, errbuf, sizeof(errbuf));
+        PQfreeCancel(cancel);
+    }
+    drain();
+    _done = true;
+#endif
+}
+
+void PgStreamingReader::drain() {
+#ifdef WITH_POSTGRESQL
+    // The connection is only usable again once every result has been read
+    while (PGresult* res = PQgetResult(_conn->getConnection())) {
+        PQclear(res);
+    }
+#endif
+}
@@ -1,11 +1,50 @@
 #include "pg/PgValue.hpp"
+#include "pg/PgBinary.hpp"
 #include "db/DBException.hpp"
-#include <cstdlib>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
 
-PgValue::PgValue() = default;
+namespace {
+// Text cells are not NUL-terminated (COPY buffers), so parse by length
+template<typename T>
+T parseText(std::string_view text, const char* where) {
+    T out{};
+    auto res = std::from_chars(text.data(), text.data() + text.size(), out);
+    if (res.ec != std::errc()) {
+        throw DBException(DBErrorCode::RESULT_PROCESSING_FAILED,
+                          std::string(where) + ": cannot parse '" + std::string(text) + "'");
+    }
+    return out;
+}
+
+// Binary cells of fixed-width types must hold exactly that many bytes; a
+// wrong OID or a short value would otherwise read past the cell
+const char* fixedWidth(std::string_view value, std::size_t width, const char* where) {
+    if (value.size() != width) {
+        throw DBException(DBErrorCode::RESULT_PROCESSING_FAILED,
+                          std::string(where) + ": expected " + std::to_string(width) +
+                              " bytes, got " + std::to_string(value.size()));
+    }
+    return value.data();
+}
 
-PgValue::PgValue(std::string v, bool isNull)
-    : _value(std::move(v)), _null(isNull) {}
+// Header of a binary numeric: ndigits, weight, sign, dscale
+constexpr std::size_t NUMERIC_HEADER = 8;
+
+const char* numericData(std::string_view value, const char* where) {
+    if (value.size() < NUMERIC_HEADER) {
+        throw DBException(DBErrorCode::RESULT_PROCESSING_FAILED,
+                          std::string(where) + ": numeric value too short");
+    }
+    return value.data();
+}
+}
+
+PgValue::PgValue(std::string_view v, bool isNull, unsigned int typeOid, bool binary)
+    : _value(v), _null(isNull), _type(typeOid), _binary(binary) {}
 
 bool PgValue::isNull() const {
     return _null;
@@ -13,15 +52,133 @@ bool PgValue::isNull() const {
 
 int PgValue::asInt() const {
     if (_null) throw DBException("PgValue::asInt: null");
-    return std::stoi(_value);
+    if (!_binary) return parseText<int>(_value, "PgValue::asInt");
+    std::int64_t v = asInt64();
+    if (v < std::numeric_limits<int>::min() || v > std::numeric_limits<int>::max()) {
+        throw DBException(DBErrorCode::RESULT_PROCESSING_FAILED,
+                          "PgValue::asInt: " + std::to_string(v) + " does not fit in int; use asInt64()");
+    }
+    return static_cast<int>(v);
 }
 
 double PgValue::asDouble() const {
     if (_null) throw DBException("PgValue::asDouble: null");
-    return std::stod(_value);
+    if (!_binary) return parseText<double>(_value, "PgValue::asDouble");
+
+    switch (_type) {
+        case PgOid::Float8:  return PgBinary::readFloat8(fixedWidth(_value, 8, "PgValue::asDouble"));
+        case PgOid::Float4:  return PgBinary::readFloat4(fixedWidth(_value, 4, "PgValue::asDouble"));
+        case PgOid::Numeric: return PgBinary::readNumeric(numericData(_value, "PgValue::asDouble"),
+                                                          static_cast<int>(_value.size()));
+        case PgOid::Int2:
+        case PgOid::Int4:
+        case PgOid::Int8:    return static_cast<double>(asInt64());
+        default:
+            throw DBException(DBErrorCode::RESULT_PROCESSING_FAILED,
+                              "PgValue::asDouble: unsupported binary type OID " + std::to_string(_type));
+    }
 }
 
 std::string PgValue::asString() const {
     if (_null) return {};
-    return _value;
+    if (!_binary) return std::string(_value);
+
+    switch (_type) {
+        case PgOid::Bool:        return asBool() ? "t" : "f";
+        case PgOid::Int2:
+        case PgOid::Int4:
+        case PgOid::Int8:        return std::to_string(asInt64());
+        case PgOid::Float4:
+        case PgOid::Float8: {
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), "%.17g", asDouble());
+            return buf;
+        }
+        case PgOid::Numeric:
+            return PgBinary::numericToString(numericData(_value, "PgValue::asString"),
+                                             static_cast<int>(_value.size()));
+        case PgOid::Date:
+            return PgBinary::dateToString(PgBinary::readInt32(fixedWidth(_value, 4, "PgValue::asString")));
+        case PgOid::Timestamp:
+            return PgBinary::timestampToString(PgBinary::readInt64(fixedWidth(_value, 8, "PgValue::asString")));
+        case PgOid::TimestampTz:
+            return PgBinary::timestampToString(PgBinary::readInt64(fixedWidth(_value, 8, "PgValue::asString"))) + "+00";
+        default:
+            // text, varchar, bpchar, name, json... are sent as raw bytes
+            return std::string(_value);
+    }
+}
+
+std::int64_t PgValue::asInt64() const {
+    if (_null) throw DBException("PgValue::asInt64: null");
+    if (!_binary) return parseText<std::int64_t>(_value, "PgValue::asInt64");
+
+    switch (_type) {
+        case PgOid::Int2:    return PgBinary::readInt16(fixedWidth(_value, 2, "PgValue::asInt64"));
+        case PgOid::Int4:    return PgBinary::readInt32(fixedWidth(_value, 4, "PgValue::asInt64"));
+        case PgOid::Int8:    return PgBinary::readInt64(fixedWidth(_value, 8, "PgValue::asInt64"));
+        case PgOid::Bool:    return fixedWidth(_value, 1, "PgValue::asInt64")[0] != 0 ? 1 : 0;
+        case PgOid::Float4:
+        case PgOid::Float8:
+        case PgOid::Numeric: {
+            // NaN, infinities and out-of-range values have no int64 form
+            double v = std::trunc(asDouble());
+            if (!(v >= -9223372036854775808.0 && v < 9223372036854775808.0)) {
+                throw DBException(DBErrorCode::RESULT_PROCESSING_FAILED,
+                                  "PgValue::asInt64: " + std::to_string(v) + " is out of int64 range");
+            }
+            return static_cast<std::int64_t>(v);
+        }
+        default:
+            throw DBException(DBErrorCode::RESULT_PROCESSING_FAILED,
+                              "PgValue::asInt64: unsupported binary type OID " + std::to_string(_type));
+    }
+}
+
+bool PgValue::asBool() const {
+    if (_null) throw DBException("PgValue::asBool: null");
+    if (!_binary) return !_value.empty() && (_value[0] == 't' || _value[0] == '1');
+    if (_type == PgOid::Bool) return !_value.empty() && _value[0] != 0;
+    return asInt64() != 0;
+}
+
+std::int64_t PgValue::asTimestamp() const {
+    if (_null) throw DBException("PgValue::asTimestamp: null");
+    if (_binary) {
+        if (_type == PgOid::Timestamp || _type == PgOid::TimestampTz)
+            return PgBinary::readInt64(fixedWidth(_value, 8, "PgValue::asTimestamp")) + PgBinary::POSTGRES_EPOCH_USEC;
+        if (_type == PgOid::Date)
+            return (static_cast<std::int64_t>(PgBinary::readInt32(fixedWidth(_value, 4, "PgValue::asTimestamp"))) +
+                    PgBinary::POSTGRES_EPOCH_DAYS) * 86400000000LL;
+        throw DBException(DBErrorCode::RESULT_PROCESSING_FAILED,
+                          "PgValue::asTimestamp: unsupported binary type OID " + std::to_string(_type));
+    }
+
+    // Text form: "YYYY-MM-DD[ HH:MM:SS[.ffffff]]" (zone suffix ignored)
+    char text[64];
+    std::size_t len = _value.size() < sizeof(text) - 1 ? _value.size() : sizeof(text) - 1;
+    std::memcpy(text, _value.data(), len);
+    text[len] = '\0';
+
+    int y = 0, mo = 0, d = 0, h = 0, mi = 0, s = 0;
+    int consumed = 0;
+    if (std::sscanf(text, "%d-%d-%d%n", &y, &mo, &d, &consumed) < 3) {
+        throw DBException(DBErrorCode::RESULT_PROCESSING_FAILED,
+                          "PgValue::asTimestamp: cannot parse '" + std::string(_value) + "'");
+    }
+    std::int64_t micros = 0;
+    const char* rest = text + consumed;
+    int timeConsumed = 0;
+    if (std::sscanf(rest, " %d:%d:%d%n", &h, &mi, &s, &timeConsumed) == 3) {
+        rest += timeConsumed;
+        if (*rest == '.') {
+            int digits = 0;
+            for (++rest; *rest >= '0' && *rest <= '9'; ++rest) {
+                if (digits++ < 6) micros = micros * 10 + (*rest - '0');
+            }
+            for (; digits < 6; ++digits) micros *= 10;
+        }
+    }
+    std::int64_t days = PgBinary::daysFromCivil(y, static_cast<unsigned>(mo), static_cast<unsigned>(d));
+    return (days * 86400LL + h * 3600LL + mi * 60LL + s) * 1000000LL + micros;
 }
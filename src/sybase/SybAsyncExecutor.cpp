@@ -0,0 +1,116 @@
+#include "sybase/SybAsyncExecutor.hpp"
+#include "sybase/SybConnection.hpp"
+#include "sybase/SybReader.hpp"
+#include "db/DBException.hpp"
+#include <cerrno>
+#include <cstring>
+#include <exception>
+
+#ifdef WITH_SYBASE
+#include <poll.h>
+#endif
+
+#ifdef WITH_SYBASE
+
+SybAsyncExecutor::~SybAsyncExecutor() {
+    std::vector<PendingQuery> pending;
+    pending.swap(_pending);
+    for (auto& query : pending) {
+        query.conn->cancelQuery();
+        if (query.callback) {
+            query.callback(nullptr, "executor closed");
+        }
+    }
+}
+
+void SybAsyncExecutor::submit(SybConnection& conn, const std::string& sql, QueryCallback callback) {
+    conn.sendQuery(sql);
+    PendingQuery query;
+    query.conn = &conn;
+    query.callback = std::move(callback);
+    _pending.push_back(std::move(query));
+}
+
+std::future<std::unique_ptr<SybReader>>
+SybAsyncExecutor::submit(SybConnection& conn, const std::string& sql) {
+    auto promise = std::make_shared<std::promise<std::unique_ptr<SybReader>>>();
+    auto future = promise->get_future();
+    submit(conn, sql, [promise](std::unique_ptr<SybReader> reader, const std::string& error) {
+        if (error.empty()) {
+            promise->set_value(std::move(reader));
+        } else {
+            promise->set_exception(std::make_exception_ptr(DBException(DBErrorCode::QUERY_FAILED, error)));
+        }
+    });
+    return future;
+}
+
+std::size_t SybAsyncExecutor::poll(int timeoutMs) {
+    if (_pending.empty()) {
+        return 0;
+    }
+
+    std::vector<pollfd> fds(_pending.size());
+    for (std::size_t i = 0; i < _pending.size(); ++i) {
+        fds[i].fd = _pending[i].conn->socket();
+        fds[i].events = POLLIN;
+        fds[i].revents = 0;
+    }
+
+    int ready = ::poll(fds.data(), fds.size(), timeoutMs);
+    if (ready < 0) {
+        if (errno == EINTR) {
+            return 0;
+        }
+        throw DBException(DBErrorCode::CONNECTION_FAILED,
+                          "SybAsyncExecutor::poll: " + std::string(std::strerror(errno)));
+    }
+    if (ready == 0) {
+        return 0;
+    }
+
+    // Detach the answered queries first: callbacks may submit new ones
+    std::vector<PendingQuery> answered;
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < _pending.size(); ++i) {
+        if (fds[i].revents != 0) {
+            answered.push_back(std::move(_pending[i]));
+        } else {
+            if (kept != i) _pending[kept] = std::move(_pending[i]);
+            ++kept;
+        }
+    }
+    _pending.resize(kept);
+
+    // A throwing callback must not strand the other answered queries:
+    // finish them all, then rethrow the first exception
+    std::exception_ptr failure;
+    for (auto& query : answered) {
+        std::unique_ptr<SybReader> reader;
+        std::string error;
+        try {
+            reader = query.conn->finishQuery();
+        } catch (const DBException& e) {
+            error = e.what();
+        }
+        if (query.callback) {
+            try {
+                query.callback(std::move(reader), error);
+            } catch (...) {
+                if (!failure) failure = std::current_exception();
+            }
+        }
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    return answered.size();
+}
+
+void SybAsyncExecutor::wait() {
+    while (!_pending.empty()) {
+        poll(-1);
+    }
+}
+
+#endif
@@ -0,0 +1,110 @@
+#include "sybase/SybBcpApi.hpp"
+#include "db/DBException.hpp"
+
+#ifdef WITH_SYBASE
+#include <sybfront.h>
+#include <sybdb.h>
+#endif
+
+#ifdef WITH_SYBASE
+
+namespace {
+int hostType(SybBcpType type) {
+    switch (type) {
+        case SybBcpType::Int:   return SYBINT4;
+        case SybBcpType::Float: return SYBFLT8;
+        default:                return SYBCHAR;
+    }
+}
+}
+
+SybDbLibBcpApi::SybDbLibBcpApi(DBPROCESS* dbproc)
+    : _dbproc(dbproc) {
+    if (!_dbproc) {
+        throw DBException("SybDbLibBcpApi: dbproc is null");
+    }
+}
+
+std::vector<std::string> SybDbLibBcpApi::tableColumns(const std::string& table) {
+    std::string sql = "SELECT * FROM " + table + " WHERE 1 = 0";
+    if (dbcmd(_dbproc, sql.c_str()) == FAIL || dbsqlexec(_dbproc) == FAIL) {
+        throw DBException(DBErrorCode::QUERY_FAILED, "SybDbLibBcpApi::tableColumns: query failed", sql);
+    }
+
+    std::vector<std::string> columns;
+    RETCODE ret;
+    while ((ret = dbresults(_dbproc)) != NO_MORE_RESULTS) {
+        if (ret == FAIL) {
+            throw DBException(DBErrorCode::QUERY_FAILED, "SybDbLibBcpApi::tableColumns: dbresults failed", sql);
+        }
+        if (columns.empty()) {
+            int count = dbnumcols(_dbproc);
+            for (int col = 1; col <= count; ++col) {
+                columns.emplace_back(dbcolname(_dbproc, col));
+            }
+        }
+        while (dbnextrow(_dbproc) != NO_MORE_ROWS) {
+            // WHERE 1 = 0: nothing to read
+        }
+    }
+    return columns;
+}
+
+bool SybDbLibBcpApi::init(const std::string& table, const std::string& hostFile, bool out) {
+    _types.clear();
+    return bcp_init(_dbproc, table.c_str(), hostFile.empty() ? nullptr : hostFile.c_str(),
+                    nullptr, out ? DB_OUT : DB_IN) == SUCCEED;
+}
+
+bool SybDbLibBcpApi::bind(int tableColumn, SybBcpType type) {
+    if (tableColumn > static_cast<int>(_types.size())) {
+        _types.resize(tableColumn, SybBcpType::Char);
+    }
+    _types[tableColumn - 1] = type;
+    // Address and length are supplied per row through bcp_colptr/bcp_collen
+    DBINT varlen = type == SybBcpType::Char ? 0 : -1;
+    return bcp_bind(_dbproc, nullptr, 0, varlen, nullptr, 0, hostType(type), tableColumn) == SUCCEED;
+}
+
+bool SybDbLibBcpApi::setColumn(int tableColumn, const void* data, int length) {
+    if (!data) {
+        return bcp_collen(_dbproc, 0, tableColumn) == SUCCEED;  // varlen 0 = NULL
+    }
+    bool fixed = _types[tableColumn - 1] != SybBcpType::Char;
+    return bcp_colptr(_dbproc, static_cast<BYTE*>(const_cast<void*>(data)), tableColumn) == SUCCEED
+        && bcp_collen(_dbproc, fixed ? -1 : length, tableColumn) == SUCCEED;
+}
+
+bool SybDbLibBcpApi::sendRow() {
+    return bcp_sendrow(_dbproc) == SUCCEED;
+}
+
+long SybDbLibBcpApi::batch() {
+    return bcp_batch(_dbproc);
+}
+
+long SybDbLibBcpApi::done() {
+    return bcp_done(_dbproc);
+}
+
+void SybDbLibBcpApi::cancel() {
+    dbcancel(_dbproc);
+}
+
+bool SybDbLibBcpApi::setHostColumns(int count) {
+    return bcp_columns(_dbproc, count) == SUCCEED;
+}
+
+bool SybDbLibBcpApi::setHostFormat(int hostColumn, int tableColumn) {
+    return bcp_colfmt(_dbproc, hostColumn, SYBCHAR, 4, -1, nullptr, 0, tableColumn) == SUCCEED;
+}
+
+long SybDbLibBcpApi::exec() {
+    DBINT rows = 0;
+    if (bcp_exec(_dbproc, &rows) != SUCCEED) {
+        return -1;
+    }
+    return rows;
+}
+
+#endif
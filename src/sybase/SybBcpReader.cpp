@@ -0,0 +1,98 @@
+#include "sybase/SybBcpReader.hpp"
+#include "db/DBException.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+namespace {
+std::string temporaryHostFile() {
+    static std::atomic<unsigned long> counter{0};
+    auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+    std::string name = "hft_bcp_" + std::to_string(stamp) + "_" + std::to_string(++counter) + ".dat";
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+}
+
+SybBcpReader::SybBcpReader(std::unique_ptr<ISybBcpApi> api, const std::string& table,
+                           const std::string& hostFile)
+    : _api(std::move(api)), _hostFile(hostFile.empty() ? temporaryHostFile() : hostFile),
+      _ownsFile(hostFile.empty()) {
+    if (!_api) {
+        throw DBException("SybBcpReader: bcp API is null");
+    }
+
+    _columns = _api->tableColumns(table);
+    if (_columns.empty()) {
+        throw DBException(DBErrorCode::INVALID_PARAMETER, "SybBcpReader: no columns in " + table);
+    }
+
+    int count = static_cast<int>(_columns.size());
+    bool ok = _api->init(table, _hostFile, true) && _api->setHostColumns(count);
+    for (int col = 1; ok && col <= count; ++col) {
+        ok = _api->setHostFormat(col, col);
+    }
+    if (ok) {
+        _rowCount = _api->exec();
+    }
+    if (!ok || _rowCount < 0) {
+        if (_ownsFile) std::remove(_hostFile.c_str());
+        throw DBException(DBErrorCode::QUERY_FAILED, "SybBcpReader: bcp out failed for " + table);
+    }
+
+    _in.open(_hostFile, std::ios::binary);
+    if (!_in) {
+        if (_ownsFile) std::remove(_hostFile.c_str());
+        throw DBException("SybBcpReader: cannot open host file " + _hostFile);
+    }
+    _fields.resize(_columns.size());
+    _row._values.resize(_columns.size());
+}
+
+SybBcpReader::~SybBcpReader() {
+    _in.close();
+    if (_ownsFile) {
+        std::remove(_hostFile.c_str());
+    }
+}
+
+bool SybBcpReader::next() {
+    _hasRow = false;
+    for (std::size_t col = 0; col < _row._values.size(); ++col) {
+        char prefix[4];
+        if (!_in.read(prefix, sizeof(prefix))) {
+            if (col == 0 && _in.gcount() == 0) {
+                return false;  // clean end of file
+            }
+            throw DBException("SybBcpReader::next: truncated host file");
+        }
+
+        std::int32_t length = 0;
+        std::memcpy(&length, prefix, sizeof(length));  // native byte order
+        if (length < 0) {
+            throw DBException("SybBcpReader::next: bad field length");
+        }
+        std::string& field = _fields[col];
+        field.resize(static_cast<std::size_t>(length));
+        if (length > 0 && !_in.read(&field[0], length)) {
+            throw DBException("SybBcpReader::next: truncated host file");
+        }
+        _row._values[col].assign(field.data(), field.size(), length == 0);
+    }
+    _hasRow = true;
+    return true;
+}
+
+IDBRow& SybBcpReader::row() {
+    if (!_hasRow) throw DBException("SybBcpReader::row: no row");
+    return _row;
+}
+
+const IDBValue& SybBcpReader::Row::operator[](std::size_t idx) const {
+    if (idx >= _values.size()) {
+        throw DBException("SybBcpReader::row: index out of range");
+    }
+    return _values[idx];
+}
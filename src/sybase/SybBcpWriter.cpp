@@ -0,0 +1,161 @@
+#include "sybase/SybBcpWriter.hpp"
+#include "db/DBException.hpp"
+#include <algorithm>
+#include <cstdio>
+
+SybBcpWriter::SybBcpWriter(std::unique_ptr<ISybBcpApi> api, const std::string& table,
+                           const std::vector<std::string>& columns, long batchSize)
+    : _api(std::move(api)), _batchSize(batchSize > 0 ? batchSize : 0) {
+    if (!_api) {
+        throw DBException("SybBcpWriter: bcp API is null");
+    }
+    if (columns.empty()) {
+        throw DBException(DBErrorCode::INVALID_PARAMETER, "SybBcpWriter: no columns");
+    }
+
+    // bcp_bind addresses table columns by ordinal
+    std::vector<std::string> tableColumns = _api->tableColumns(table);
+    _fields.resize(columns.size());
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+        auto it = std::find(tableColumns.begin(), tableColumns.end(), columns[i]);
+        if (it == tableColumns.end()) {
+            throw DBException(DBErrorCode::INVALID_PARAMETER,
+                              "SybBcpWriter: no column " + columns[i] + " in " + table);
+        }
+        _fields[i].tableColumn = static_cast<int>(it - tableColumns.begin()) + 1;
+    }
+    _written.resize(columns.size());
+
+    if (!_api->init(table, std::string(), false)) {
+        throw DBException(DBErrorCode::QUERY_FAILED, "SybBcpWriter: bcp_init failed for " + table);
+    }
+    _active = true;
+}
+
+SybBcpWriter::~SybBcpWriter() {
+    if (_active) {
+        _api->cancel();
+    }
+}
+
+SybBcpWriter::Field& SybBcpWriter::nextField(const char* caller) {
+    if (!_inRow) {
+        throw DBException(std::string(caller) + ": startRow() not called");
+    }
+    if (_fieldsInRow >= _fields.size()) {
+        throw DBException(DBErrorCode::INVALID_PARAMETER, std::string(caller) + ": too many fields in row");
+    }
+    return _fields[_fieldsInRow++];
+}
+
+void SybBcpWriter::startRow() {
+    if (!_active) {
+        throw DBException("SybBcpWriter::startRow: writer is finished");
+    }
+    if (_inRow) {
+        sendRow();
+    }
+    _inRow = true;
+    _fieldsInRow = 0;
+}
+
+void SybBcpWriter::writeNull() {
+    Field& field = nextField("SybBcpWriter::writeNull");
+    field.isNull = true;
+    _written[_fieldsInRow - 1] = field.type;
+    if (!_bound) field.type = SybBcpType::Char;
+}
+
+void SybBcpWriter::writeInt(int value) {
+    Field& field = nextField("SybBcpWriter::writeInt");
+    field.isNull = false;
+    field.intValue = value;
+    _written[_fieldsInRow - 1] = SybBcpType::Int;
+    if (!_bound) field.type = SybBcpType::Int;
+}
+
+void SybBcpWriter::writeDouble(double value) {
+    Field& field = nextField("SybBcpWriter::writeDouble");
+    field.isNull = false;
+    field.doubleValue = value;
+    _written[_fieldsInRow - 1] = SybBcpType::Float;
+    if (!_bound) field.type = SybBcpType::Float;
+}
+
+void SybBcpWriter::writeString(const std::string& value) {
+    Field& field = nextField("SybBcpWriter::writeString");
+    field.isNull = value.empty();
+    field.text = value;
+    _written[_fieldsInRow - 1] = SybBcpType::Char;
+    if (!_bound) field.type = SybBcpType::Char;
+}
+
+void SybBcpWriter::sendRow() {
+    if (_fieldsInRow != _fields.size()) {
+        throw DBException(DBErrorCode::INVALID_PARAMETER, "SybBcpWriter: row has " +
+                          std::to_string(_fieldsInRow) + " fields, expected " + std::to_string(_fields.size()));
+    }
+
+    if (!_bound) {
+        for (const Field& field : _fields) {
+            if (!_api->bind(field.tableColumn, field.type)) {
+                throw DBException(DBErrorCode::QUERY_FAILED, "SybBcpWriter: bcp_bind failed");
+            }
+        }
+        _bound = true;
+    }
+
+    for (std::size_t i = 0; i < _fields.size(); ++i) {
+        Field& field = _fields[i];
+        bool ok = true;
+        if (field.isNull) {
+            ok = _api->setColumn(field.tableColumn, nullptr, 0);
+        } else if (field.type == SybBcpType::Int && _written[i] == SybBcpType::Int) {
+            ok = _api->setColumn(field.tableColumn, &field.intValue, sizeof(field.intValue));
+        } else if (field.type == SybBcpType::Float && _written[i] != SybBcpType::Char) {
+            if (_written[i] == SybBcpType::Int) {
+                field.doubleValue = field.intValue;
+            }
+            ok = _api->setColumn(field.tableColumn, &field.doubleValue, sizeof(field.doubleValue));
+        } else if (field.type == SybBcpType::Char) {
+            if (_written[i] == SybBcpType::Int) {
+                field.text = std::to_string(field.intValue);
+            } else if (_written[i] == SybBcpType::Float) {
+                char buffer[32];
+                int n = std::snprintf(buffer, sizeof(buffer), "%.17g", field.doubleValue);
+                field.text.assign(buffer, n);
+            }
+            ok = _api->setColumn(field.tableColumn, field.text.data(), static_cast<int>(field.text.size()));
+        } else {
+            throw DBException(DBErrorCode::INVALID_PARAMETER,
+                              "SybBcpWriter: field " + std::to_string(i) + " does not match its bound type");
+        }
+        if (!ok) {
+            throw DBException(DBErrorCode::QUERY_FAILED, "SybBcpWriter: bcp_colptr/bcp_collen failed");
+        }
+    }
+
+    if (!_api->sendRow()) {
+        throw DBException(DBErrorCode::QUERY_FAILED, "SybBcpWriter: bcp_sendrow failed");
+    }
+    ++_rows;
+    _inRow = false;
+
+    if (_batchSize > 0 && _rows % _batchSize == 0 && _api->batch() < 0) {
+        throw DBException(DBErrorCode::QUERY_FAILED, "SybBcpWriter: bcp_batch failed");
+    }
+}
+
+long SybBcpWriter::finish() {
+    if (!_active) {
+        throw DBException("SybBcpWriter::finish: writer is finished");
+    }
+    if (_inRow) {
+        sendRow();
+    }
+    _active = false;
+    if (_api->done() < 0) {
+        throw DBException(DBErrorCode::QUERY_FAILED, "SybBcpWriter: bcp_done failed");
+    }
+    return _rows;
+}
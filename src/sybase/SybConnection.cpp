@@ -3,6 +3,10 @@
 #include "sybase/SybReader.hpp"
 #include "sybase/SybPreparedStatement.hpp"
 #include "sybase/SybTransaction.hpp"
+#include "sybase/SybBcpApi.hpp"
+#include "sybase/SybBcpReader.hpp"
+#include "sybase/SybBcpWriter.hpp"
+#include "db/Logger.hpp"
 #include <sstream>
 
 #ifdef WITH_SYBASE
@@ -60,6 +64,7 @@ SybConnection::SybConnection(const std::string& conninfo)
     // Set login properties
     DBSETLUSER(login, user.c_str());
     DBSETLPWD(login, password.c_str());
+    BCP_SETL(login, TRUE);  // allow bulk copy on this connection
     if (!database.empty()) {
         DBSETLDBNAME(login, database.c_str());
     }
@@ -85,6 +90,11 @@ SybConnection::SybConnection(const std::string& conninfo)
 SybConnection::~SybConnection() {
 
     if (_dbproc) {
+        for (const auto& entry : _rpcProcedures) {
+            if (!entry.second.empty()) {
+                runBatch("drop procedure " + entry.second);
+            }
+        }
         dbclose(_dbproc);
         _dbproc = nullptr;
     }
@@ -108,12 +118,155 @@ SybConnection::executeQuery(const std::string& sql) {
         throw DBException("SybConnection::executeQuery: dbsqlexec failed");
     }
     
-    // Get first result set
-    if (dbresults(_dbproc) != SUCCEED) {
-        throw DBException("SybConnection::executeQuery: dbresults failed");
+    // Reader advances to the first result set with rows
+    return std::make_unique<SybReader>(_dbproc, true);
+}
+
+std::unique_ptr<SybReader>
+SybConnection::executeBatch(const std::vector<std::string>& statements) {
+
+    if (!_dbproc) {
+        throw DBException("SybConnection::executeBatch: Connection is null");
+    }
+    
+    // dbcmd() appends to the command buffer; one dbsqlexec() sends it all
+    for (const auto& sql : statements) {
+        if (dbcmd(_dbproc, sql.c_str()) == FAIL || dbcmd(_dbproc, "\n") == FAIL) {
+            dbfreebuf(_dbproc);
+            throw DBException("SybConnection::executeBatch: dbcmd failed");
+        }
+    }
+    
+    if (dbsqlexec(_dbproc) == FAIL) {
+        throw DBException("SybConnection::executeBatch: dbsqlexec failed");
+    }
+    
+    return std::make_unique<SybReader>(_dbproc, true);
+}
+
+std::vector<long>
+SybConnection::executeBatchUpdate(const std::vector<std::string>& statements) {
+
+    auto reader = executeBatch(statements);
+    while (reader->nextResultSet()) {
+    }
+    return reader->rowCounts();
+}
+
+long SybConnection::streamText(const std::string& sql, const TextChunkCallback& callback,
+                               std::size_t chunkSize) {
+
+    if (!_dbproc) {
+        throw DBException("SybConnection::streamText: Connection is null");
+    }
+    if (chunkSize == 0) {
+        throw DBException(DBErrorCode::INVALID_PARAMETER, "SybConnection::streamText: chunkSize is 0");
+    }
+    
+    // TEXTSIZE would otherwise cut every value at the session limit; the
+    // session's own setting is put back once the values have been read
+    long previousTextSize = selectLong("select @@textsize");
+    auto restoreTextSize = [&] {
+        if (previousTextSize > 0) {
+            runBatch("set textsize " + std::to_string(previousTextSize));
+        }
+    };
+    std::string batch = "set textsize 2147483647\n" + sql;
+    if (dbcmd(_dbproc, batch.c_str()) == FAIL || dbsqlexec(_dbproc) == FAIL) {
+        dbcancel(_dbproc);
+        restoreTextSize();
+        throw DBException(DBErrorCode::QUERY_FAILED, "SybConnection::streamText: query failed");
+    }
+    
+    RETCODE ret;
+    while ((ret = dbresults(_dbproc)) == SUCCEED && dbnumcols(_dbproc) == 0) {
+    }
+    if (ret == NO_MORE_RESULTS) {
+        restoreTextSize();
+        return 0;
+    }
+    if (ret == FAIL || dbnumcols(_dbproc) != 1 ||
+        (dbcoltype(_dbproc, 1) != SYBTEXT && dbcoltype(_dbproc, 1) != SYBIMAGE)) {
+        dbcancel(_dbproc);
+        restoreTextSize();
+        throw DBException(DBErrorCode::INVALID_PARAMETER,
+                          "SybConnection::streamText: query must return one TEXT or IMAGE column");
+    }
+    
+    std::vector<char> chunk(chunkSize);
+    long row = 0;
+    try {
+        for (;;) {
+            STATUS n = dbreadtext(_dbproc, chunk.data(), static_cast<DBINT>(chunk.size()));
+            if (n == NO_MORE_ROWS) {
+                break;
+            }
+            if (n < 0) {
+                throw DBException(DBErrorCode::RESULT_PROCESSING_FAILED,
+                                  "SybConnection::streamText: dbreadtext failed");
+            }
+            if (n == 0) {
+                callback(row++, std::string_view(), true);  // end of this row's value
+            } else {
+                callback(row, std::string_view(chunk.data(), static_cast<std::size_t>(n)), false);
+            }
+        }
+    } catch (...) {
+        dbcancel(_dbproc);  // also when the callback throws
+        restoreTextSize();
+        throw;
+    }
+    
+    while (dbresults(_dbproc) != NO_MORE_RESULTS) {
+        // Consume trailing results
+    }
+    restoreTextSize();
+    return row;
+}
+
+void SybConnection::sendQuery(const std::string& sql) {
+
+    if (!_dbproc) {
+        throw DBException("SybConnection::sendQuery: Connection is null");
+    }
+    if (_queryPending) {
+        throw DBException("SybConnection::sendQuery: a query is already pending");
     }
     
-    return std::make_unique<SybReader>(_dbproc);
+    if (dbcmd(_dbproc, sql.c_str()) == FAIL) {
+        throw DBException("SybConnection::sendQuery: dbcmd failed");
+    }
+    if (dbsqlsend(_dbproc) == FAIL) {
+        throw DBException("SybConnection::sendQuery: dbsqlsend failed");
+    }
+    _queryPending = true;
+}
+
+std::unique_ptr<SybReader>
+SybConnection::finishQuery() {
+
+    if (!_queryPending) {
+        throw DBException("SybConnection::finishQuery: no query pending");
+    }
+    _queryPending = false;
+    
+    if (dbsqlok(_dbproc) == FAIL) {
+        dbcancel(_dbproc);
+        throw DBException(DBErrorCode::QUERY_FAILED, "SybConnection::finishQuery: dbsqlok failed");
+    }
+    return std::make_unique<SybReader>(_dbproc, true);
+}
+
+void SybConnection::cancelQuery() {
+
+    if (_queryPending) {
+        dbcancel(_dbproc);
+        _queryPending = false;
+    }
+}
+
+int SybConnection::socket() const {
+    return _dbproc ? dbiordesc(_dbproc) : -1;
 }
 
 std::unique_ptr<IDBPreparedStatement>
@@ -146,10 +299,116 @@ SybConnection::beginTransaction() {
         // Empty loop to consume all results
     }
     
+    ++_transactionDepth;
     return std::make_unique<SybTransaction>(this);
 // #else
 //     throw DBException("Sybase support not compiled in");
 
 }
 
+std::unique_ptr<IDBBulkWriter>
+SybConnection::beginBulkInsert(const std::string& table, const std::vector<std::string>& columns) {
+
+    if (!_dbproc) {
+        throw DBException("SybConnection::beginBulkInsert: Connection is null");
+    }
+    return std::make_unique<SybBcpWriter>(std::make_unique<SybDbLibBcpApi>(_dbproc),
+                                          table, columns, _bcpBatchSize);
+}
+
+std::unique_ptr<IDBReader>
+SybConnection::beginBulkExtract(const std::string& table) {
+
+    if (!_dbproc) {
+        throw DBException("SybConnection::beginBulkExtract: Connection is null");
+    }
+    return std::make_unique<SybBcpReader>(std::make_unique<SybDbLibBcpApi>(_dbproc), table);
+}
+
+bool SybConnection::runBatch(const std::string& sql) {
+
+    if (dbcmd(_dbproc, sql.c_str()) == FAIL || dbsqlexec(_dbproc) == FAIL) {
+        dbcancel(_dbproc);
+        return false;
+    }
+    RETCODE ret;
+    while ((ret = dbresults(_dbproc)) != NO_MORE_RESULTS) {
+        if (ret == FAIL) {
+            dbcancel(_dbproc);
+            return false;
+        }
+        while (dbnextrow(_dbproc) != NO_MORE_ROWS) {
+        }
+    }
+    return true;
+}
+
+const std::string*
+SybConnection::rpcProcedure(const std::string& body, const std::string& declarations) {
+
+    if (!_dbproc) {
+        throw DBException("SybConnection::rpcProcedure: Connection is null");
+    }
+
+    std::string key;
+    key.reserve(declarations.size() + 1 + body.size());
+    key.append(declarations).push_back('\0');
+    key.append(body);
+
+    auto it = _rpcProcedures.find(key);
+    if (it != _rpcProcedures.end()) {
+        if (it->second.empty()) {
+            ++_rpcFallbacks;
+            return nullptr;
+        }
+        return &it->second;
+    }
+
+    // DDL is refused inside a transaction; do not cache, try again later
+    if (_transactionDepth > 0) {
+        ++_rpcFallbacks;
+        return nullptr;
+    }
+
+    // Procedure names carry the spid so concurrent sessions never collide
+    if (_rpcPrefix.empty()) {
+        long spid = selectLong("select @@spid");
+        _rpcPrefix = "hft_rpc_" + std::to_string(spid < 0 ? 0 : spid) + "_";
+    }
+
+    // A session that died before its destructor ran leaves its procedures
+    // behind, and a later session can be given the same spid
+    std::string name = _rpcPrefix + std::to_string(++_rpcCounter);
+    runBatch("if object_id('" + name + "') is not null drop procedure " + name);
+    if (!runBatch("create procedure " + name + " " + declarations + " as " + body)) {
+        // Remember the failure and stay on the literal path
+        Logger::instance().log(LogLevel::WARNING,
+                               "SybConnection: cannot create procedure " + name +
+                               " (CREATE PROCEDURE permission?); executing as literal SQL");
+        name.clear();
+        ++_rpcFallbacks;
+    }
+    auto& stored = _rpcProcedures.emplace(std::move(key), std::move(name)).first->second;
+    return stored.empty() ? nullptr : &stored;
+}
+
+long SybConnection::selectLong(const char* sql) {
+
+    long result = -1;
+    if (dbcmd(_dbproc, sql) == FAIL || dbsqlexec(_dbproc) == FAIL) {
+        dbcancel(_dbproc);
+        return result;
+    }
+    while (dbresults(_dbproc) == SUCCEED) {
+        while (dbnextrow(_dbproc) == REG_ROW) {
+            DBINT value = 0;
+            if (dbconvert(_dbproc, dbcoltype(_dbproc, 1), dbdata(_dbproc, 1), dbdatlen(_dbproc, 1),
+                          SYBINT4, reinterpret_cast<BYTE*>(&value), sizeof(value)) > 0) {
+                result = value;
+            }
+        }
+    }
+    return result;
+}
+
 #endif
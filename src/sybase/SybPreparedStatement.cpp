@@ -11,109 +11,144 @@
 
 #ifdef WITH_SYBASE
 
+namespace {
+// Longest varchar declared for an RPC parameter; longer strings are sent
+// as literals
+constexpr std::size_t MAX_RPC_VARCHAR = 16384;
+}
+
 SybPreparedStatement::SybPreparedStatement(std::string sql, SybConnection* conn)
-    : _sql(std::move(sql)), _conn(conn) {}
+    : _template(sql), _conn(conn) {}
 
 SybPreparedStatement::~SybPreparedStatement() = default;
 
-void SybPreparedStatement::bindInt(int index, int value) {
-    if (index <= 0) throw DBException("SybPreparedStatement::bindInt: index <= 0");
-    if (static_cast<std::size_t>(index) > _params.size())
+SybPreparedStatement::Param& SybPreparedStatement::param(int index, const char* caller) {
+    if (index <= 0) throw DBException(std::string(caller) + ": index <= 0");
+    if (static_cast<std::size_t>(index) > _params.size()) {
         _params.resize(index);
-    _params[index - 1] = std::to_string(value);
+        while (_paramNames.size() < _params.size()) {
+            _paramNames.push_back("@p" + std::to_string(_paramNames.size() + 1));
+        }
+    }
+    return _params[index - 1];
+}
+
+void SybPreparedStatement::bindInt(int index, int value) {
+    Param& p = param(index, "SybPreparedStatement::bindInt");
+    p.type = Param::Type::Int;
+    p.intValue = value;
 }
 
 void SybPreparedStatement::bindDouble(int index, double value) {
-    if (index <= 0) throw DBException("SybPreparedStatement::bindDouble: index <= 0");
-    if (static_cast<std::size_t>(index) > _params.size())
-        _params.resize(index);
-    _params[index - 1] = std::to_string(value);
+    Param& p = param(index, "SybPreparedStatement::bindDouble");
+    p.type = Param::Type::Double;
+    p.doubleValue = value;
 }
 
 void SybPreparedStatement::bindString(int index, const std::string& value) {
-    if (index <= 0) throw DBException("SybPreparedStatement::bindString: index <= 0");
-    if (static_cast<std::size_t>(index) > _params.size())
-        _params.resize(index);
-    // Escape single quotes for Sybase
-    std::string escaped;
-    for (char c : value) {
-        if (c == '\'') {
-            escaped += "''";  // Double the quote
-        } else {
-            escaped += c;
-        }
-    }
-    _params[index - 1] = "'" + escaped + "'";
+    Param& p = param(index, "SybPreparedStatement::bindString");
+    p.type = Param::Type::String;
+    p.text = value;
 }
 
-std::string SybPreparedStatement::buildFinalSQL() {
-    // Replace $1, $2, etc. with actual parameter values
-    std::string result = _sql;
-    for (size_t i = 0; i < _params.size(); ++i) {
-        std::string placeholder = "$" + std::to_string(i + 1);
-        
-        // Replace all occurrences of this placeholder
-        size_t pos = 0;
-        while ((pos = result.find(placeholder, pos)) != std::string::npos) {
-            result.replace(pos, placeholder.length(), _params[i]);
-            pos += _params[i].length();
+std::string SybPreparedStatement::buildDeclarations() const {
+    std::string decl;
+    for (std::size_t i = 0; i < _params.size(); ++i) {
+        const Param& p = _params[i];
+        if (i > 0) decl += ", ";
+        decl += _paramNames[i];
+        switch (p.type) {
+            case Param::Type::Int:
+                decl += " int";
+                break;
+            case Param::Type::Double:
+                decl += " float";
+                break;
+            case Param::Type::String: {
+                // Round up so nearby lengths share one procedure
+                std::size_t len = 256;
+                while (len < p.text.size()) len *= 2;
+                if (len > MAX_RPC_VARCHAR) return std::string();
+                decl += " varchar(" + std::to_string(len) + ")";
+                break;
+            }
+            default:
+                return std::string();  // unbound parameter
         }
     }
-    return result;
+    return decl;
 }
 
-std::unique_ptr<IDBReader> SybPreparedStatement::executeQuery() {
-
+void SybPreparedStatement::send(const char* caller) {
     if (!_conn || !_conn->getDbProcess()) {
-        throw DBException("SybPreparedStatement::executeQuery: Connection is null");
+        throw DBException(std::string(caller) + ": Connection is null");
     }
-    
     DBPROCESS* dbproc = _conn->getDbProcess();
-    std::string finalSQL = buildFinalSQL();
-    
-    // Send SQL command
-    if (dbcmd(dbproc, finalSQL.c_str()) == FAIL) {
-        throw DBException("SybPreparedStatement::executeQuery: dbcmd failed");
+
+    const std::string* procedure = nullptr;
+    if (_conn->rpcExecution() && !_params.empty()) {
+        std::string declarations = buildDeclarations();
+        if (!declarations.empty()) {
+            procedure = _conn->rpcProcedure(_template.rpcBody(), declarations);
+        }
     }
-    
-    // Execute query
-    if (dbsqlexec(dbproc) == FAIL) {
-        throw DBException("SybPreparedStatement::executeQuery: dbsqlexec failed");
+
+    if (!procedure) {
+        std::string finalSQL = _template.render(_params);
+        if (dbcmd(dbproc, finalSQL.c_str()) == FAIL) {
+            throw DBException(std::string(caller) + ": dbcmd failed");
+        }
+        if (dbsqlexec(dbproc) == FAIL) {
+            throw DBException(std::string(caller) + ": dbsqlexec failed");
+        }
+        return;
     }
-    
-    // Get first result set
-    if (dbresults(dbproc) != SUCCEED) {
-        throw DBException("SybPreparedStatement::executeQuery: dbresults failed");
+
+    if (dbrpcinit(dbproc, const_cast<char*>(procedure->c_str()), 0) == FAIL) {
+        throw DBException(std::string(caller) + ": dbrpcinit failed");
     }
+    for (std::size_t i = 0; i < _params.size(); ++i) {
+        Param& p = _params[i];
+        char* name = const_cast<char*>(_paramNames[i].c_str());
+        RETCODE ret;
+        if (p.type == Param::Type::Int) {
+            ret = dbrpcparam(dbproc, name, 0, SYBINT4, -1, -1, reinterpret_cast<BYTE*>(&p.intValue));
+        } else if (p.type == Param::Type::Double) {
+            ret = dbrpcparam(dbproc, name, 0, SYBFLT8, -1, -1, reinterpret_cast<BYTE*>(&p.doubleValue));
+        } else {
+            // A zero length would mean NULL; Sybase stores '' as ' ' anyway
+            static char space[] = " ";
+            BYTE* data = reinterpret_cast<BYTE*>(p.text.empty() ? space : &p.text[0]);
+            DBINT len = p.text.empty() ? 1 : static_cast<DBINT>(p.text.size());
+            ret = dbrpcparam(dbproc, name, 0, SYBVARCHAR, -1, len, data);
+        }
+        if (ret == FAIL) {
+            throw DBException(std::string(caller) + ": dbrpcparam failed for " + _paramNames[i]);
+        }
+    }
+    if (dbrpcsend(dbproc) == FAIL || dbsqlok(dbproc) == FAIL) {
+        throw DBException(std::string(caller) + ": RPC " + *procedure + " failed");
+    }
+}
+
+std::unique_ptr<IDBReader> SybPreparedStatement::executeQuery() {
+
+    send("SybPreparedStatement::executeQuery");
+    DBPROCESS* dbproc = _conn->getDbProcess();
     
-    return std::make_unique<SybReader>(dbproc);
+    // Reader skips row-less results (e.g. DML ahead of the SELECT)
+    return std::make_unique<SybReader>(dbproc, true);
 }
 
 void SybPreparedStatement::executeUpdate() {
 
-    if (!_conn || !_conn->getDbProcess()) {
-        throw DBException("SybPreparedStatement::executeUpdate: Connection is null");
-    }
-    
+    send("SybPreparedStatement::executeUpdate");
     DBPROCESS* dbproc = _conn->getDbProcess();
-    std::string finalSQL = buildFinalSQL();
-    
-    // Send SQL command
-    if (dbcmd(dbproc, finalSQL.c_str()) == FAIL) {
-        throw DBException("SybPreparedStatement::executeUpdate: dbcmd failed");
-    }
-    
-    // Execute update
-    if (dbsqlexec(dbproc) == FAIL) {
-        throw DBException("SybPreparedStatement::executeUpdate: dbsqlexec failed");
-    }
     
     // Consume results
     while (dbresults(dbproc) != NO_MORE_RESULTS) {
         // Empty loop to consume all results
     }
-// #else
-//     throw DBException("Sybase support not compiled in");
 }
 
-#endif
\ No newline at end of file
+#endif
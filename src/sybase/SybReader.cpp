@@ -9,35 +9,99 @@
 
 #ifdef WITH_SYBASE
 
-SybReader::SybReader(DBPROCESS* dbproc)
+SybReader::SybReader(DBPROCESS* dbproc, bool pending)
     : _dbproc(dbproc) {
-    (void)dbproc;
-    throw DBException("Sybase support not compiled in");
+    if (!_dbproc) {
+        throw DBException("SybReader: dbproc is null");
+    }
+    if (pending) {
+        advance();
+    } else {
+        _row.bind(_dbproc);
+        _inResultSet = true;
+    }
 }
 
-SybReader::~SybReader() = default;
+SybReader::~SybReader() {
+    if (_dbproc && !_done) {
+        dbcancel(_dbproc);
+    }
+}
 
 bool SybReader::next() {
-    if (!_dbproc) {
+    _hasRow = false;
+    _computeId = 0;
+    if (!_inResultSet) {
         return false;
     }
     
-    RETCODE ret = dbnextrow(_dbproc);
-    if (ret == NO_MORE_ROWS) {
-        return false;
-    }
-    if (ret == FAIL || ret == BUF_FULL) {
-        throw DBException("SybReader::next: dbnextrow failed");
+    for (;;) {
+        RETCODE ret = dbnextrow(_dbproc);
+        if (ret == NO_MORE_ROWS) {
+            finishResultSet();
+            return false;
+        }
+        if (ret == FAIL || ret == BUF_FULL) {
+            throw DBException("SybReader::next: dbnextrow failed");
+        }
+        if (ret == REG_ROW) {
+            break;
+        }
+        // COMPUTE row: ret is its compute id; not written to the bound buffers
+        if (_computeRows) {
+            _computeRow.loadCompute(_dbproc, ret);
+            _computeId = ret;
+            _hasRow = true;
+            return true;
+        }
     }
     
-    // ret should be REG_ROW or one of the compute row types
-    _row = std::make_unique<SybRow>(_dbproc);
+    _row.refresh();
+    _hasRow = true;
     return true;
 }
 
 IDBRow& SybReader::row() {
-    if (!_row) throw DBException("SybReader::row: no row");
-    return *_row;
+    if (!_hasRow) throw DBException("SybReader::row: no row");
+    return _computeId ? _computeRow : _row;
 }
 
-#endif
\ No newline at end of file
+bool SybReader::nextResultSet() {
+    _hasRow = false;
+    _computeId = 0;
+    if (_inResultSet) {
+        if (dbcanquery(_dbproc) == FAIL) {
+            throw DBException("SybReader::nextResultSet: dbcanquery failed");
+        }
+        finishResultSet();
+    }
+    return advance();
+}
+
+void SybReader::finishResultSet() {
+    _inResultSet = false;
+    _rowCounts.push_back(DBCOUNT(_dbproc));
+}
+
+bool SybReader::advance() {
+    while (!_done) {
+        RETCODE ret = dbresults(_dbproc);
+        if (ret == NO_MORE_RESULTS) {
+            _done = true;
+            break;
+        }
+        if (ret == FAIL) {
+            throw DBException(DBErrorCode::QUERY_FAILED, "SybReader: dbresults failed");
+        }
+        if (dbnumcols(_dbproc) > 0) {
+            _row.bind(_dbproc);
+            _inResultSet = true;
+            return true;
+        }
+        // Statement without rows (DML, DDL, SET ...)
+        _rowCounts.push_back(DBCOUNT(_dbproc));
+    }
+    return false;
+}
+
+#endif
@@ -1,6 +1,7 @@
 #include "sybase/SybRow.hpp"
 #include "sybase/SybValue.hpp"
 #include "db/DBException.hpp"
+#include <algorithm>
 
 #ifdef WITH_SYBASE
 #include <sybfront.h>
@@ -8,65 +9,126 @@
 #endif
 
 #ifdef WITH_SYBASE
-SybRow::SybRow(DBPROCESS* dbproc) {
 
+namespace {
+// Character buffer large enough for the column converted to text
+std::size_t textBufferSize(int coltype, DBINT collen) {
+    std::size_t len = collen > 0 ? static_cast<std::size_t>(collen) : 0;
+    switch (coltype) {
+        case SYBCHAR:
+        case SYBVARCHAR:
+            return len + 1;
+        case SYBBINARY:
+        case SYBVARBINARY:
+        case SYBLONGBINARY:      // also univarchar/unichar
+            return 2 * len + 3;  // hex digits, "0x", NUL
+        default:
+            // Numeric, money and datetime fit in 64; anything wider (long
+            // or national character types) gets the binary bound, since
+            // NTBSTRINGBIND truncates silently
+            return std::max<std::size_t>(64, 2 * len + 3);
+    }
+}
+}
+
+SybRow::~SybRow() = default;
+
+void SybRow::bind(DBPROCESS* dbproc) {
     if (!dbproc) {
-        throw DBException("SybRow: dbproc is null");
+        throw DBException("SybRow::bind: dbproc is null");
     }
-    
+    _dbproc = dbproc;
+    _unbound.clear();
+
+    // Buffers must not move once dbbind() has their addresses; earlier
+    // text storage is kept and only grown
     int numCols = dbnumcols(dbproc);
-    _values.reserve(numCols);
-    
+    _buffers.resize(numCols);
+    _values.resize(numCols);
+
     for (int col = 1; col <= numCols; ++col) {  // Sybase columns are 1-based
-        BYTE* data = dbdata(dbproc, col);
-        DBINT datalen = dbdatlen(dbproc, col);
-        
-        bool isNull = (data == nullptr || datalen == 0);
-        std::string value;
-        
-        if (!isNull) {
-            int coltype = dbcoltype(dbproc, col);
-            
-            // Convert data based on type
-            switch (coltype) {
-                case SYBINT1:
-                case SYBINT2:
-                case SYBINT4:
-                case SYBINT8: {
-                    DBINT intval = 0;
-                    dbconvert(dbproc, coltype, data, datalen, SYBINT4, (BYTE*)&intval, -1);
-                    value = std::to_string(intval);
-                    break;
-                }
-                case SYBREAL:
-                case SYBFLT8: {
-                    DBFLT8 dblval = 0.0;
-                    dbconvert(dbproc, coltype, data, datalen, SYBFLT8, (BYTE*)&dblval, -1);
-                    value = std::to_string(dblval);
-                    break;
-                }
-                case SYBCHAR:
-                case SYBVARCHAR:
-                case SYBTEXT:
-                    value.assign((char*)data, datalen);
-                    break;
-                default:
-                    // For other types, try to convert to string
-                    char buffer[256];
-                    DBINT converted = dbconvert(dbproc, coltype, data, datalen, 
-                                               SYBCHAR, (BYTE*)buffer, sizeof(buffer));
-                    if (converted >= 0) {
-                        value.assign(buffer, converted);
-                    }
-                    break;
-            }
+        Buffer& buf = _buffers[col - 1];
+        SybValue& value = _values[col - 1];
+        int coltype = dbcoltype(dbproc, col);
+        RETCODE ret = SUCCEED;
+
+        switch (coltype) {
+            case SYBBIT:
+            case SYBINT1:
+            case SYBINT2:
+            case SYBINT4:
+                ret = dbbind(dbproc, col, INTBIND, 0, reinterpret_cast<BYTE*>(&buf.intValue));
+                value.bindInt(&buf.intValue, &buf.indicator);
+                break;
+            case SYBINT8:
+                ret = dbbind(dbproc, col, BIGINTBIND, 0, reinterpret_cast<BYTE*>(&buf.int64Value));
+                value.bindInt64(&buf.int64Value, &buf.indicator);
+                break;
+            case SYBREAL:
+            case SYBFLT8:
+                ret = dbbind(dbproc, col, FLT8BIND, 0, reinterpret_cast<BYTE*>(&buf.doubleValue));
+                value.bindDouble(&buf.doubleValue, &buf.indicator);
+                break;
+            case SYBTEXT:
+            case SYBIMAGE:
+                _unbound.push_back(col);
+                value.assign(nullptr, 0, true);
+                continue;
+            default:
+                buf.text.resize(std::max(buf.text.size(), textBufferSize(coltype, dbcollen(dbproc, col))));
+                ret = dbbind(dbproc, col, NTBSTRINGBIND, static_cast<DBINT>(buf.text.size()),
+                             reinterpret_cast<BYTE*>(buf.text.data()));
+                value.bindText(buf.text.data(), &buf.indicator);
+                break;
+        }
+
+        if (ret == FAIL || dbnullbind(dbproc, col, &buf.indicator) == FAIL) {
+            throw DBException(DBErrorCode::RESULT_PROCESSING_FAILED,
+                              "SybRow::bind: dbbind failed for column " + std::to_string(col));
         }
-        
-        _values.push_back(std::make_unique<SybValue>(value, isNull));
     }
 }
 
-SybRow::~SybRow() = default;
+void SybRow::refresh() {
+    for (int col : _unbound) {
+        BYTE* data = dbdata(_dbproc, col);
+        DBINT len = dbdatlen(_dbproc, col);
+        _values[col - 1].assign(reinterpret_cast<const char*>(data), data ? static_cast<std::size_t>(len) : 0,
+                                data == nullptr);
+    }
+}
+
+void SybRow::loadCompute(DBPROCESS* dbproc, int computeId) {
+    _dbproc = dbproc;
+    _unbound.clear();
+
+    int numAlts = dbnumalts(dbproc, computeId);
+    _buffers.resize(numAlts);
+    _values.resize(numAlts);
+
+    for (int col = 1; col <= numAlts; ++col) {
+        Buffer& buf = _buffers[col - 1];
+        SybValue& value = _values[col - 1];
+        BYTE* data = dbadata(dbproc, computeId, col);
+        DBINT len = dbadlen(dbproc, computeId, col);
+        if (!data) {
+            value.assign(nullptr, 0, true);
+            continue;
+        }
+        int type = dbalttype(dbproc, computeId, col);
+        buf.text.resize(std::max(buf.text.size(), textBufferSize(type, len)));
+        // Bounded by the buffer: a value wider than textBufferSize() fails
+        // the conversion instead of overrunning it
+        DBINT converted = dbconvert(dbproc, type, data, len, SYBCHAR,
+                                    reinterpret_cast<BYTE*>(buf.text.data()),
+                                    static_cast<DBINT>(buf.text.size()));
+        if (converted < 0) {
+            throw DBException(DBErrorCode::RESULT_PROCESSING_FAILED,
+                              "SybRow::loadCompute: dbconvert failed for column " + std::to_string(col));
+        }
+        value.assign(buf.text.data(), static_cast<std::size_t>(converted), false);
+    }
+}
 
 std::size_t SybRow::columnCount() const {
     return _values.size();
@@ -76,7 +138,7 @@ const IDBValue& SybRow::operator[](std::size_t idx) const {
     if (idx >= _values.size()) {
         throw DBException("SybRow::operator[]: index out of range");
     }
-    return *_values[idx];
+    return _values[idx];
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,81 @@
+#include "sybase/SybSqlTemplate.hpp"
+#include <cctype>
+#include <charconv>
+
+SybSqlTemplate::SybSqlTemplate(const std::string& sql) {
+    std::string segment;
+    char quote = 0;
+    for (std::size_t i = 0; i < sql.size(); ++i) {
+        char c = sql[i];
+        if (quote) {
+            if (c == quote) quote = 0;
+        } else if (c == '\'' || c == '"') {
+            quote = c;
+        } else if (c == '$' && i + 1 < sql.size() && std::isdigit(static_cast<unsigned char>(sql[i + 1]))) {
+            std::size_t start = i;
+            int index = 0;
+            while (i + 1 < sql.size() && std::isdigit(static_cast<unsigned char>(sql[i + 1]))) {
+                index = index * 10 + (sql[++i] - '0');
+            }
+            if (index > 0) {
+                _segmentBytes += segment.size();
+                _segments.push_back(std::move(segment));
+                segment.clear();
+                _slots.push_back(index - 1);
+                continue;
+            }
+            segment.append(sql, start, i - start + 1);  // $0 is not a parameter
+            continue;
+        }
+        segment += c;
+    }
+    _segmentBytes += segment.size();
+    _segments.push_back(std::move(segment));
+
+    _rpcBody.reserve(_segmentBytes + _slots.size() * 4);
+    for (std::size_t i = 0; i < _slots.size(); ++i) {
+        _rpcBody += _segments[i];
+        _rpcBody += "@p";
+        _rpcBody += std::to_string(_slots[i] + 1);
+    }
+    _rpcBody += _segments.back();
+}
+
+std::string SybSqlTemplate::render(const std::vector<SybSqlParam>& params) const {
+    std::size_t size = _segmentBytes;
+    for (int slot : _slots) {
+        if (static_cast<std::size_t>(slot) < params.size() && params[slot].type == SybSqlParam::Type::String) {
+            size += params[slot].text.size() + 2;
+        } else {
+            size += 24;
+        }
+    }
+
+    std::string result;
+    result.reserve(size);
+    char buf[32];
+    for (std::size_t i = 0; i < _slots.size(); ++i) {
+        result += _segments[i];
+        std::size_t slot = static_cast<std::size_t>(_slots[i]);
+        const SybSqlParam* p = slot < params.size() ? &params[slot] : nullptr;
+        if (!p || p->type == SybSqlParam::Type::Unbound) {
+            // Never bound: leave the placeholder for the server to reject
+            result += '$';
+            result += std::to_string(slot + 1);
+        } else if (p->type == SybSqlParam::Type::Int) {
+            result.append(buf, std::to_chars(buf, buf + sizeof(buf), p->intValue).ptr);
+        } else if (p->type == SybSqlParam::Type::Double) {
+            result.append(buf, std::to_chars(buf, buf + sizeof(buf), p->doubleValue).ptr);
+        } else {
+            // Escape single quotes for Sybase
+            result += '\'';
+            for (char c : p->text) {
+                if (c == '\'') result += '\'';  // Double the quote
+                result += c;
+            }
+            result += '\'';
+        }
+    }
+    result += _segments.back();
+    return result;
+}
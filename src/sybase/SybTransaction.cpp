@@ -46,6 +46,7 @@ void SybTransaction::commit() {
     }
     
     _active = false;
+    if (_conn->_transactionDepth > 0) --_conn->_transactionDepth;
 }
 
 void SybTransaction::rollback() {
@@ -71,6 +72,7 @@ void SybTransaction::rollback() {
     }
     
     _active = false;
+    _conn->_transactionDepth = 0;  // ROLLBACK TRAN ends every nesting level
 }
 
 #endif
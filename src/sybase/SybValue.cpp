@@ -1,31 +1,115 @@
 #include "sybase/SybValue.hpp"
 #include "db/DBException.hpp"
-#include <cstdlib>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <limits>
 
-#ifdef WITH_SYBASE
+namespace {
+template<typename T>
+T parseText(std::string_view text, const char* where) {
+    T out{};
+    auto res = std::from_chars(text.data(), text.data() + text.size(), out);
+    if (res.ec != std::errc()) {
+        throw DBException(DBErrorCode::RESULT_PROCESSING_FAILED,
+                          std::string(where) + ": cannot parse '" + std::string(text) + "'");
+    }
+    return out;
+}
+}
+
+SybValue::SybValue(std::string_view v, bool isNull)
+    : _text(isNull ? std::string_view() : v), _null(isNull) {}
+
+void SybValue::bindInt(const std::int32_t* data, const std::int32_t* nullIndicator) {
+    _kind = Kind::Int;
+    _data = data;
+    _indicator = nullIndicator;
+    _null = false;
+}
+
+void SybValue::bindInt64(const std::int64_t* data, const std::int32_t* nullIndicator) {
+    _kind = Kind::Int64;
+    _data = data;
+    _indicator = nullIndicator;
+    _null = false;
+}
 
-SybValue::SybValue() = default;
+void SybValue::bindDouble(const double* data, const std::int32_t* nullIndicator) {
+    _kind = Kind::Double;
+    _data = data;
+    _indicator = nullIndicator;
+    _null = false;
+}
 
-SybValue::SybValue(std::string v, bool isNull)
-    : _value(std::move(v)), _null(isNull) {}
+void SybValue::bindText(const char* data, const std::int32_t* nullIndicator) {
+    _kind = Kind::Text;
+    _data = data;
+    _indicator = nullIndicator;
+    _text = std::string_view();
+    _null = false;
+}
 
 bool SybValue::isNull() const {
-    return _null;
+    return _indicator ? *_indicator == -1 : _null;
+}
+
+std::string_view SybValue::asStringView() const {
+    if (isNull() || _kind != Kind::Text) return {};
+    return _data ? std::string_view(static_cast<const char*>(_data)) : _text;
+}
+
+std::int64_t SybValue::asInt64() const {
+    if (isNull()) throw DBException("SybValue::asInt64: null");
+    switch (_kind) {
+        case Kind::Int:    return *static_cast<const std::int32_t*>(_data);
+        case Kind::Int64:  return *static_cast<const std::int64_t*>(_data);
+        case Kind::Double: {
+            // NaN, infinities and out-of-range values have no int64 form
+            double v = std::trunc(*static_cast<const double*>(_data));
+            if (!(v >= -9223372036854775808.0 && v < 9223372036854775808.0)) {
+                throw DBException(DBErrorCode::RESULT_PROCESSING_FAILED,
+                                  "SybValue::asInt64: " + std::to_string(v) + " is out of int64 range");
+            }
+            return static_cast<std::int64_t>(v);
+        }
+        default:           return parseText<std::int64_t>(asStringView(), "SybValue::asInt64");
+    }
 }
 
 int SybValue::asInt() const {
-    if (_null) throw DBException("SybValue::asInt: null");
-    return std::stoi(_value);
+    if (isNull()) throw DBException("SybValue::asInt: null");
+    if (_kind == Kind::Text) return parseText<int>(asStringView(), "SybValue::asInt");
+    std::int64_t v = asInt64();
+    if (v < std::numeric_limits<int>::min() || v > std::numeric_limits<int>::max()) {
+        throw DBException(DBErrorCode::RESULT_PROCESSING_FAILED,
+                          "SybValue::asInt: " + std::to_string(v) + " does not fit in int; use asInt64()");
+    }
+    return static_cast<int>(v);
 }
 
 double SybValue::asDouble() const {
-    if (_null) throw DBException("SybValue::asDouble: null");
-    return std::stod(_value);
+    if (isNull()) throw DBException("SybValue::asDouble: null");
+    switch (_kind) {
+        case Kind::Int:    return *static_cast<const std::int32_t*>(_data);
+        case Kind::Int64:  return static_cast<double>(*static_cast<const std::int64_t*>(_data));
+        case Kind::Double: return *static_cast<const double*>(_data);
+        default:           return parseText<double>(asStringView(), "SybValue::asDouble");
+    }
 }
 
 std::string SybValue::asString() const {
-    if (_null) return {};
-    return _value;
+    if (isNull()) return {};
+    switch (_kind) {
+        case Kind::Int:
+        case Kind::Int64:
+            return std::to_string(asInt64());
+        case Kind::Double: {
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), "%.17g", *static_cast<const double*>(_data));
+            return buf;
+        }
+        default:
+            return std::string(asStringView());
+    }
 }
-
-#endif
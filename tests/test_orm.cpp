@@ -44,6 +44,7 @@ public:
     
     std::shared_ptr<hft::db::IStatement> createStatement(const std::string& sql) override {
         lastSQL = sql;
+        ++statementCount;
         return std::make_shared<MockStatement>();
     }
     
@@ -52,6 +53,7 @@ public:
     std::string getLastError() const override { return ""; }
     
     std::string lastSQL;
+    int statementCount = 0;
 };
 
 // Test entity
@@ -155,6 +157,111 @@ TEST(RepositoryTest, DeleteAllGeneratesCorrectSQL) {
     EXPECT_EQ(mockConn->lastSQL, "DELETE FROM products");
 }
 
+TEST(RepositoryTest, InsertBatchGeneratesMultiRowValues) {
+    auto mockConn = std::make_shared<MockConnection>();
+    Repository<Product> repo(mockConn);
+    
+    std::vector<Product> products(2);
+    repo.insertBatch(products);
+    
+    EXPECT_EQ(mockConn->lastSQL,
+              "INSERT INTO products (name, price, quantity) VALUES ($1, $2, $3), ($4, $5, $6)");
+}
+
+TEST(RepositoryTest, InsertBatchChunksAtParameterLimit) {
+    auto mockConn = std::make_shared<MockConnection>();
+    Repository<Product> repo(mockConn);
+    
+    // 3 bound columns: 65535 / 3 = 21845 rows per statement
+    std::vector<Product> products(21845 + 2);
+    repo.insertBatch(products);
+    
+    EXPECT_EQ(mockConn->statementCount, 2);
+    EXPECT_EQ(mockConn->lastSQL,
+              "INSERT INTO products (name, price, quantity) VALUES ($1, $2, $3), ($4, $5, $6)");
+    
+    // Leftover rows go out in power-of-two chunks: 3 = 2 + 1
+    products.push_back(Product{});
+    mockConn->statementCount = 0;
+    repo.insertBatch(products);
+    
+    EXPECT_EQ(mockConn->statementCount, 3);
+    EXPECT_EQ(mockConn->lastSQL, "INSERT INTO products (name, price, quantity) VALUES ($1, $2, $3)");
+}
+
+// Result set of `rows` rows whose id column is the row number
+class CountingResultSet : public hft::db::IResultSet {
+public:
+    explicit CountingResultSet(int rows) : rows_(rows) {}
+    bool next() override { return ++current_ <= rows_; }
+    int32_t getInt(int) const override { return current_; }
+    int64_t getLong(int) const override { return current_; }
+    double getDouble(int) const override { return 0.0; }
+    std::string getString(int) const override { return ""; }
+    bool isNull(int) const override { return false; }
+    int getColumnCount() const override { return 4; }
+    std::string getColumnName(int) const override { return ""; }
+    
+    int current_ = 0;
+    int rows_;
+};
+
+class CursorConnection : public MockConnection {
+public:
+    std::shared_ptr<hft::db::IResultSet> openCursor(const std::string& sql, int fetchSize) override {
+        lastSQL = sql;
+        lastFetchSize = fetchSize;
+        auto result = std::make_shared<CountingResultSet>(1000000);
+        cursor = result;
+        return result;
+    }
+    
+    std::weak_ptr<CountingResultSet> cursor;
+    int lastFetchSize = 0;
+};
+
+TEST(RepositoryTest, StreamMapsRowsLazilyAndStopsEarly) {
+    auto mockConn = std::make_shared<CursorConnection>();
+    Repository<Product> repo(mockConn);
+    
+    {
+        auto stream = repo.stream(500);
+        const Product* first = nullptr;
+        int64_t sum = 0;
+        for (const auto& product : stream) {
+            if (!first) first = &product;
+            EXPECT_EQ(first, &product);  // one entity reused for every row
+            sum += product.id;
+            if (product.id == 3) break;
+        }
+        EXPECT_EQ(sum, 6);
+        EXPECT_EQ(mockConn->cursor.lock()->current_, 3);  // nothing read past the break
+        EXPECT_EQ(mockConn->lastSQL, "SELECT * FROM products");
+        EXPECT_EQ(mockConn->lastFetchSize, 500);
+    }
+    EXPECT_TRUE(mockConn->cursor.expired());  // result set released with the stream
+}
+
+TEST(RepositoryTest, FindByIdsChunksInLists) {
+    auto mockConn = std::make_shared<MockConnection>();
+    Repository<Product> repo(mockConn);
+    
+    std::vector<int64_t> ids;
+    for (int64_t id = 300; id >= 1; --id) {
+        ids.push_back(id);
+    }
+    ids.push_back(7);  // duplicates are looked up once
+    
+    auto products = repo.findByIds(ids);
+    
+    ASSERT_EQ(products.size(), ids.size());
+    EXPECT_FALSE(products.front().has_value());
+    // 250 IDs per list: 300 unique IDs take two statements
+    EXPECT_EQ(mockConn->statementCount, 2);
+    EXPECT_EQ(mockConn->lastSQL.rfind("SELECT * FROM products WHERE id IN ($1, $2,", 0), 0u);
+    EXPECT_NE(mockConn->lastSQL.find("$50)"), std::string::npos);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -1,6 +1,18 @@
 #include <gtest/gtest.h>
 #include "hft/db/PostgreSQLConnection.h"
+#include "hft/db/PostgreSQLAsyncConnection.h"
+#include "hft/pg/PgConnection.hpp"
+#include "hft/pg/PgValue.hpp"
+#include "hft/pg/PgNotificationListener.hpp"
+#include "hft/db/QueryResultCache.hpp"
+#include "hft/db/IDBPreparedStatement.hpp"
+#include "hft/db/IDBReader.hpp"
+#include "hft/db/IDBRow.hpp"
+#include "hft/pg/PgBinary.hpp"
+#include "hft/db/DBException.hpp"
+#include "hft/repository/Repository.hpp"
 #include <memory>
+#include <thread>
 
 using namespace hft::db;
 
@@ -64,6 +76,179 @@ TEST_F(PostgreSQLTest, PreparedStatement) {
     }
 }
 
+TEST_F(PostgreSQLTest, PreparedStatementBinaryParameters) {
+    bool opened = conn->open("host=localhost port=5432 dbname=postgres user=postgres password=postgres");
+    
+    if (!opened) {
+        GTEST_SKIP() << "PostgreSQL server not available";
+    }
+    
+    auto stmt = conn->createStatement("SELECT $1::float8 = 0.1 + 0.2, $2::bigint, $3 IS NULL, $4::text");
+    ASSERT_NE(stmt, nullptr);
+    
+    // Binary float8 keeps every bit; std::to_string would have sent "0.300000"
+    stmt->bindDouble(1, 0.1 + 0.2);
+    stmt->bindLong(2, 9007199254740993LL);
+    stmt->bindNull(3);
+    stmt->bindString(4, "abc");
+    
+    auto result = stmt->executeQuery();
+    ASSERT_NE(result, nullptr);
+    ASSERT_TRUE(result->next());
+    EXPECT_EQ(result->getString(0), "t");
+    EXPECT_EQ(result->getLong(1), 9007199254740993LL);
+    EXPECT_EQ(result->getString(2), "t");
+    EXPECT_EQ(result->getString(3), "abc");
+    
+    // Rebinding with a different type selects a separately prepared statement
+    stmt->bindInt(2, 7);
+    result = stmt->executeQuery();
+    ASSERT_NE(result, nullptr);
+    ASSERT_TRUE(result->next());
+    EXPECT_EQ(result->getLong(1), 7);
+}
+
+TEST_F(PostgreSQLTest, StatementRegistrySharesAndEvicts) {
+    bool opened = conn->open("host=localhost port=5432 dbname=postgres user=postgres password=postgres");
+    
+    if (!opened) {
+        GTEST_SKIP() << "PostgreSQL server not available";
+    }
+    
+    auto& registry = conn->statementRegistry();
+    registry.setCapacity(conn->getHandle(), 2);
+    
+    // Two statements with the same SQL share one server-side plan
+    for (int i = 0; i < 2; ++i) {
+        auto stmt = conn->createStatement("SELECT $1::int + 1");
+        stmt->bindInt(1, i);
+        auto result = stmt->executeQuery();
+        ASSERT_NE(result, nullptr);
+        ASSERT_TRUE(result->next());
+        EXPECT_EQ(result->getInt(0), i + 1);
+    }
+    EXPECT_EQ(registry.misses(), 1u);
+    EXPECT_EQ(registry.hits(), 1u);
+    
+    auto count = conn->createStatement("SELECT count(*) FROM pg_prepared_statements WHERE name LIKE 'hft_stmt_%'");
+    auto result = count->executeQuery();
+    ASSERT_NE(result, nullptr);
+    ASSERT_TRUE(result->next());
+    EXPECT_EQ(result->getLong(0), 2);
+    
+    // A third distinct query evicts the least recently used one
+    auto other = conn->createStatement("SELECT $1::int * 2");
+    other->bindInt(1, 21);
+    result = other->executeQuery();
+    ASSERT_NE(result, nullptr);
+    ASSERT_TRUE(result->next());
+    EXPECT_EQ(result->getInt(0), 42);
+    EXPECT_EQ(registry.size(), 2u);
+    EXPECT_EQ(registry.evictions(), 1u);
+    
+    // The evicted statement is prepared again on demand
+    auto again = conn->createStatement("SELECT $1::int + 1");
+    again->bindInt(1, 9);
+    result = again->executeQuery();
+    ASSERT_NE(result, nullptr);
+    ASSERT_TRUE(result->next());
+    EXPECT_EQ(result->getInt(0), 10);
+    EXPECT_EQ(registry.misses(), 4u);
+    EXPECT_TRUE(registry.lastEvictionError().empty());
+    
+    // Statements deallocated behind the registry's back are simply dropped
+    ASSERT_TRUE(conn->execute("DEALLOCATE ALL"));
+    registry.setCapacity(conn->getHandle(), 1);
+    EXPECT_EQ(registry.size(), 1u);
+    EXPECT_EQ(registry.evictions(), 3u);
+    EXPECT_FALSE(registry.lastEvictionError().empty());
+}
+
+TEST(ResultMetadataTest, IndexesColumnsByName) {
+    ResultMetadata metadata({{"id", 20, -1}, {"price", 1700, 655366}, {"id", 25, -1}});
+    
+    EXPECT_EQ(metadata.getColumnCount(), 3);
+    EXPECT_EQ(metadata.findColumn("price"), 1);
+    EXPECT_EQ(metadata.getColumn(1).typeModifier, 655366);
+    // Duplicate names resolve to the first column
+    EXPECT_EQ(metadata.findColumn("id"), 0);
+    EXPECT_EQ(metadata.findColumn("missing"), -1);
+}
+
+TEST_F(PostgreSQLTest, ResultSetLooksUpColumnsByName) {
+    bool opened = conn->open("host=localhost port=5432 dbname=postgres user=postgres password=postgres");
+    
+    if (!opened) {
+        GTEST_SKIP() << "PostgreSQL server not available";
+    }
+    
+    auto stmt = conn->createStatement("SELECT $1::int AS qty, 'x'::varchar(8) AS tag, NULL::float8 AS px");
+    stmt->bindInt(1, 5);
+    std::shared_ptr<IResultSet> first = stmt->executeQuery();
+    ASSERT_NE(first, nullptr);
+    ASSERT_TRUE(first->next());
+    EXPECT_EQ(first->getInt("qty"), 5);
+    EXPECT_EQ(first->getString("tag"), "x");
+    EXPECT_TRUE(first->isNull("px"));
+    EXPECT_TRUE(first->isNull("nope"));
+    
+    auto metadata = first->getMetadata();
+    EXPECT_EQ(metadata->getColumn(0).typeOid, 23u);
+    EXPECT_EQ(metadata->getColumn(1).typeModifier, 8 + 4);
+    
+    // Re-executing the statement reuses the metadata object
+    stmt->bindInt(1, 6);
+    std::shared_ptr<IResultSet> second = stmt->executeQuery();
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(second->getMetadata(), metadata);
+}
+
+TEST_F(PostgreSQLTest, CursorPagesThroughResult) {
+    bool opened = conn->open("host=localhost port=5432 dbname=postgres user=postgres password=postgres");
+    
+    if (!opened) {
+        GTEST_SKIP() << "PostgreSQL server not available";
+    }
+    
+    auto result = conn->openCursor("SELECT g FROM generate_series(1, 1000) g", 64);
+    ASSERT_NE(result, nullptr);
+    EXPECT_EQ(result->getColumnCount(), 1);
+    EXPECT_EQ(result->getColumnName(0), "g");
+    
+    int count = 0;
+    long sum = 0;
+    while (result->next()) {
+        sum += result->getInt(0);
+        ++count;
+    }
+    EXPECT_EQ(count, 1000);
+    EXPECT_EQ(sum, 500500);
+    
+    // The cursor and the transaction it opened end with the result set
+    result.reset();
+    auto check = conn->createStatement("SELECT count(*), now() = statement_timestamp() FROM pg_cursors");
+    auto state = check->executeQuery();
+    ASSERT_TRUE(state && state->next());
+    EXPECT_EQ(state->getInt(0), 0);
+    EXPECT_EQ(state->getString(1), "t");
+}
+
+TEST_F(PostgreSQLTest, CursorFetchFailureIsNotEndOfData) {
+    bool opened = conn->open("host=localhost port=5432 dbname=postgres user=postgres password=postgres");
+    
+    if (!opened) {
+        GTEST_SKIP() << "PostgreSQL server not available";
+    }
+    
+    // The third row divides by zero, in the second page
+    auto result = conn->openCursor("SELECT 1 / (3 - g) FROM generate_series(1, 5) g", 2);
+    ASSERT_NE(result, nullptr);
+    EXPECT_TRUE(result->next());
+    EXPECT_TRUE(result->next());
+    EXPECT_THROW(result->next(), std::runtime_error);
+    EXPECT_NE(conn->getLastError().find("division by zero"), std::string::npos);
+}
+
 TEST_F(PostgreSQLTest, Transaction) {
     bool opened = conn->open("host=localhost port=5432 dbname=postgres user=postgres password=postgres");
     
@@ -97,6 +282,581 @@ TEST_F(PostgreSQLTest, TransactionRollback) {
     EXPECT_FALSE(txn->isActive());
 }
 
+TEST(PostgreSQLAsyncTest, QueriesCompleteInOrder) {
+    PostgreSQLAsyncConnection async;
+    if (!async.open("host=localhost port=5432 dbname=postgres user=postgres password=postgres")) {
+        GTEST_SKIP() << "PostgreSQL server not available";
+    }
+    EXPECT_GE(async.socket(), 0);
+
+    std::vector<int> order;
+    std::string failure;
+    for (int i = 0; i < 3; ++i) {
+        std::string sql = (i == 1) ? "SELECT 1/0" : "SELECT $1::int";
+        std::vector<std::string> params;
+        if (i != 1) params.push_back(std::to_string(i));
+        ASSERT_TRUE(async.sendQuery(sql, params, [&, i](std::shared_ptr<IResultSet> result, const std::string& error) {
+            order.push_back(i);
+            if (i == 1) {
+                failure = error;
+            } else if (result && result->next()) {
+                EXPECT_EQ(result->getInt(0), i);
+            }
+        }));
+    }
+    auto future = async.sendQuery("SELECT 'done'");
+    EXPECT_EQ(async.pending(), 4u);
+
+    // Stand-in for an event loop: a real one waits on socket() readiness
+    while (async.pending() > 0) {
+        if (async.wantsWrite()) {
+            ASSERT_TRUE(async.onWritable());
+        }
+        ASSERT_TRUE(async.onReadable());
+    }
+
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2}));
+    EXPECT_FALSE(failure.empty());  // division by zero fails only its own query
+    auto result = future.get();
+    ASSERT_TRUE(result && result->next());
+    EXPECT_EQ(result->getString(0), "done");
+}
+
+TEST(PgValueBinaryTest, DecodesIntegersAndFloats) {
+    // PgValue is a view, so the cell bytes must outlive it
+    const std::string i4raw("\x00\x00\x01\x2c", 4);
+    PgValue i4(i4raw, false, PgOid::Int4, true);
+    EXPECT_EQ(i4.asInt(), 300);
+    EXPECT_EQ(i4.asString(), "300");
+
+    const std::string i8raw("\xff\xff\xff\xff\xff\xff\xff\xfe", 8);
+    PgValue i8(i8raw, false, PgOid::Int8, true);
+    EXPECT_EQ(i8.asInt64(), -2);
+
+    // 1.5 as IEEE-754 double, big-endian
+    const std::string f8raw("\x3f\xf8\x00\x00\x00\x00\x00\x00", 8);
+    PgValue f8(f8raw, false, PgOid::Float8, true);
+    EXPECT_DOUBLE_EQ(f8.asDouble(), 1.5);
+
+    const std::string braw("\x01", 1);
+    PgValue b(braw, false, PgOid::Bool, true);
+    EXPECT_TRUE(b.asBool());
+}
+
+TEST(PgValueBinaryTest, RejectsShortCellsAndOutOfRangeValues) {
+    const std::string big("\x00\x00\x00\x01\x00\x00\x00\x00", 8);  // 2^32
+    PgValue i8(big, false, PgOid::Int8, true);
+    EXPECT_EQ(i8.asInt64(), 4294967296LL);
+    EXPECT_THROW(i8.asInt(), DBException);
+
+    const std::string shortRaw("\x00\x01", 2);
+    PgValue wrongOid(shortRaw, false, PgOid::Int8, true);
+    EXPECT_THROW(wrongOid.asInt64(), DBException);
+    PgValue shortNumeric(shortRaw, false, PgOid::Numeric, true);
+    EXPECT_THROW(shortNumeric.asDouble(), DBException);
+
+    // +Infinity as IEEE-754 double
+    const std::string infRaw("\x7f\xf0\x00\x00\x00\x00\x00\x00", 8);
+    PgValue inf(infRaw, false, PgOid::Float8, true);
+    EXPECT_THROW(inf.asInt64(), DBException);
+}
+
+TEST(PgValueTextTest, ParsesUnterminatedCells) {
+    // COPY buffers hold cells back to back with no terminator
+    const char buf[] = "42-1.25";
+    PgValue i(std::string_view(buf, 2), false);
+    PgValue d(std::string_view(buf + 2, 5), false);
+    EXPECT_EQ(i.asInt(), 42);
+    EXPECT_EQ(i.asString(), "42");
+    EXPECT_DOUBLE_EQ(d.asDouble(), -1.25);
+
+    PgValue bad(std::string_view("x1", 2), false);
+    EXPECT_THROW(bad.asInt(), DBException);
+}
+
+TEST(PgValueBinaryTest, DecodesNumeric) {
+    // -12345.678: ndigits=3 weight=1 sign=NEG dscale=3, digits 1 2345 6780
+    std::string raw("\x00\x03\x00\x01\x40\x00\x00\x03"
+                    "\x00\x01\x09\x29\x1a\x7c", 14);
+    PgValue n(raw, false, PgOid::Numeric, true);
+    EXPECT_NEAR(n.asDouble(), -12345.678, 1e-9);
+    EXPECT_EQ(n.asString(), "-12345.678");
+}
+
+TEST(PgValueBinaryTest, DecodesTimestamp) {
+    // 2000-01-02 00:00:01.5 = 86401500000 microseconds after the PostgreSQL epoch
+    std::string raw("\x00\x00\x00\x14\x1d\xee\x43\x60", 8);
+    PgValue ts(raw, false, PgOid::Timestamp, true);
+    EXPECT_EQ(ts.asString(), "2000-01-02 00:00:01.5");
+    EXPECT_EQ(ts.asTimestamp(), PgBinary::POSTGRES_EPOCH_USEC + 86401500000LL);
+
+    PgValue text("2000-01-02 00:00:01.5", false, PgOid::Timestamp, false);
+    EXPECT_EQ(text.asTimestamp(), ts.asTimestamp());
+}
+
+TEST(PgBinaryTest, EncodesCopyFields) {
+    std::string out;
+    PgBinary::appendInt16(out, -1);
+    PgBinary::appendInt32(out, 300);
+    PgBinary::appendFloat8(out, 1.5);
+    EXPECT_EQ(out, std::string("\xff\xff" "\x00\x00\x01\x2c" "\x3f\xf8\x00\x00\x00\x00\x00\x00", 14));
+    EXPECT_EQ(PgBinary::readInt32(out.data() + 2), 300);
+}
+
+TEST(PgBinaryTest, EncodesArrayHeader) {
+    std::string out;
+    PgBinary::appendArrayHeader(out, PgOid::Int4, 3);
+    ASSERT_EQ(out.size(), 20u);
+    EXPECT_EQ(PgBinary::readInt32(out.data()), 1);        // ndim
+    EXPECT_EQ(PgBinary::readInt32(out.data() + 4), 0);    // no NULLs
+    EXPECT_EQ(PgBinary::readUInt32(out.data() + 8), PgOid::Int4);
+    EXPECT_EQ(PgBinary::readInt32(out.data() + 12), 3);   // length
+    EXPECT_EQ(PgBinary::readInt32(out.data() + 16), 1);   // lower bound
+}
+
+// PgConnection throws when no server is reachable; tests skip in that case
+static std::unique_ptr<PgConnection> openPgConnection() {
+    try {
+        return std::make_unique<PgConnection>("host=localhost port=5432 dbname=postgres user=postgres password=postgres");
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+TEST(PgConnectionTest, ServerPreparedStatementsAreShared) {
+    auto pg = openPgConnection();
+    if (!pg) {
+        GTEST_SKIP() << "PostgreSQL server not available";
+    }
+    pg->setServerPrepare(true);
+
+    for (int i = 0; i < 2; ++i) {
+        auto stmt = pg->prepare("SELECT $1::int * 2");
+        stmt->bindInt(1, 21);
+        auto reader = stmt->executeQuery();
+        ASSERT_TRUE(reader->next());
+        EXPECT_EQ(reader->row()[0].asInt(), 42);
+    }
+    EXPECT_EQ(pg->preparedStatementCount(), 1u);
+}
+
+TEST(PgConnectionTest, ArrayParametersExpandWithUnnest) {
+    auto pg = openPgConnection();
+    if (!pg) {
+        GTEST_SKIP() << "PostgreSQL server not available";
+    }
+
+    auto stmt = pg->prepare("SELECT count(*), sum(i), sum(d), string_agg(s, '|' ORDER BY i) "
+                            "FROM unnest($1::int4[], $2::float8[], $3::text[]) AS u(i, d, s)");
+    stmt->bindIntArray(1, {1, 2, 3});
+    stmt->bindDoubleArray(2, {0.5, 0.25, 0.125});
+    stmt->bindStringArray(3, {"a", "b,\"c\"", ""});
+    auto reader = stmt->executeQuery();
+    ASSERT_TRUE(reader->next());
+    EXPECT_EQ(reader->row()[0].asInt(), 3);
+    EXPECT_EQ(reader->row()[1].asInt(), 6);
+    EXPECT_DOUBLE_EQ(reader->row()[2].asDouble(), 0.875);
+    EXPECT_EQ(reader->row()[3].asString(), "a|b,\"c\"|");
+}
+
+TEST(PgConnectionTest, StreamingQueryReturnsAllRows) {
+    auto pg = openPgConnection();
+    if (!pg) {
+        GTEST_SKIP() << "PostgreSQL server not available";
+    }
+
+    auto reader = pg->executeStreamingQuery("SELECT g FROM generate_series(1, 1000) g",
+                                            FetchMode::SingleRow, 1);
+    int count = 0;
+    long sum = 0;
+    while (reader->next()) {
+        sum += reader->row()[0].asInt();
+        ++count;
+    }
+    EXPECT_EQ(count, 1000);
+    EXPECT_EQ(sum, 500500);
+
+    // Abandoning a stream part-way must leave the connection usable
+    reader = pg->executeStreamingQuery("SELECT g FROM generate_series(1, 100000) g",
+                                       FetchMode::SingleRow, 1);
+    ASSERT_TRUE(reader->next());
+    reader.reset();
+    auto check = pg->executeQuery("SELECT 1");
+    EXPECT_TRUE(check->next());
+}
+
+TEST(PgConnectionTest, CursorReaderRefillsPages) {
+    auto pg = openPgConnection();
+    if (!pg) {
+        GTEST_SKIP() << "PostgreSQL server not available";
+    }
+
+    // 1000 rows in pages of 100: the last FETCH returns an empty page
+    auto reader = pg->executeStreamingQuery("SELECT g FROM generate_series(1, 1000) g",
+                                            FetchMode::Cursor, 100);
+    int count = 0;
+    long sum = 0;
+    while (reader->next()) {
+        sum += reader->row()[0].asInt();
+        ++count;
+    }
+    EXPECT_EQ(count, 1000);
+    EXPECT_EQ(sum, 500500);
+
+    // Abandoning a cursor part-way closes it and its transaction
+    reader = pg->executeStreamingQuery("SELECT g FROM generate_series(1, 100000) g",
+                                       FetchMode::Cursor, 100);
+    ASSERT_TRUE(reader->next());
+    reader.reset();
+    auto check = pg->executeQuery("SELECT count(*), now() = statement_timestamp() FROM pg_cursors");
+    ASSERT_TRUE(check->next());
+    EXPECT_EQ(check->row()[0].asInt(), 0);
+    EXPECT_EQ(check->row()[1].asString(), "t");
+}
+
+TEST(PgConnectionTest, PipelineCollectsPerStatementResults) {
+    auto pg = openPgConnection();
+    if (!pg) {
+        GTEST_SKIP() << "PostgreSQL server not available";
+    }
+    pg->prepare("CREATE TEMP TABLE pipeline_test (id int PRIMARY KEY)")->executeUpdate();
+
+    auto stmt = pg->prepare("INSERT INTO pipeline_test VALUES ($1)");
+    std::vector<DBPipelineResult> results;
+    {
+        auto pipeline = pg->beginPipeline();
+        ASSERT_NE(pipeline, nullptr);
+        for (int i : {1, 2, 2, 3}) {
+            stmt->bindInt(1, i);
+            stmt->executeUpdate();
+        }
+        EXPECT_EQ(pipeline->pending(), 4u);
+        results = pipeline->sync();
+    }
+
+    ASSERT_EQ(results.size(), 4u);
+    EXPECT_TRUE(results[0].ok);
+    EXPECT_EQ(results[0].affectedRows, 1);
+    EXPECT_TRUE(results[1].ok);
+    EXPECT_FALSE(results[2].ok);  // duplicate key
+    EXPECT_FALSE(results[3].ok);  // aborted with the rest of the pipeline
+}
+
+TEST(PgConnectionTest, CopyWriterLoadsRows) {
+    auto pg = openPgConnection();
+    if (!pg) {
+        GTEST_SKIP() << "PostgreSQL server not available";
+    }
+    pg->prepare("CREATE TEMP TABLE copy_test (n int, x double precision, s text)")->executeUpdate();
+    pg->setCopyBufferSize(64);  // force several PQputCopyData calls
+
+    auto writer = pg->beginBulkInsert("copy_test", {"n", "x", "s"});
+    ASSERT_NE(writer, nullptr);
+    for (int i = 0; i < 100; ++i) {
+        writer->startRow();
+        writer->writeInt(i);
+        writer->writeDouble(i * 0.5);
+        if (i % 10 == 0) {
+            writer->writeNull();
+        } else {
+            writer->writeString("row " + std::to_string(i));
+        }
+    }
+    EXPECT_EQ(writer->finish(), 100);
+
+    auto reader = pg->executeQuery("SELECT count(*), sum(n), sum(x), count(s) FROM copy_test");
+    ASSERT_TRUE(reader->next());
+    EXPECT_EQ(reader->row()[0].asInt(), 100);
+    EXPECT_EQ(reader->row()[1].asInt(), 4950);
+    EXPECT_DOUBLE_EQ(reader->row()[2].asDouble(), 2475.0);
+    EXPECT_EQ(reader->row()[3].asInt(), 90);
+}
+
+TEST(PgConnectionTest, CopyOutReaderDecodesRows) {
+    auto pg = openPgConnection();
+    if (!pg) {
+        GTEST_SKIP() << "PostgreSQL server not available";
+    }
+
+    auto reader = pg->executeCopyOut(
+        "SELECT g, g * 0.5::float8, CASE WHEN g % 10 = 0 THEN NULL ELSE 'row ' || g END "
+        "FROM generate_series(1, 1000) g");
+    int count = 0;
+    long sum = 0;
+    int nulls = 0;
+    while (reader->next()) {
+        auto& row = reader->row();
+        ASSERT_EQ(row.columnCount(), 3u);
+        sum += row[0].asInt();
+        EXPECT_DOUBLE_EQ(row[1].asDouble(), row[0].asInt() * 0.5);
+        if (row[2].isNull()) {
+            ++nulls;
+        } else {
+            EXPECT_EQ(row[2].asString(), "row " + std::to_string(row[0].asInt()));
+        }
+        ++count;
+    }
+    EXPECT_EQ(count, 1000);
+    EXPECT_EQ(sum, 500500);
+    EXPECT_EQ(nulls, 100);
+
+    // Abandoning an export part-way must leave the connection usable
+    reader = pg->executeCopyOut("SELECT g FROM generate_series(1, 1000000) g");
+    ASSERT_TRUE(reader->next());
+    reader.reset();
+    auto check = pg->executeQuery("SELECT 1");
+    EXPECT_TRUE(check->next());
+}
+
+TEST(PgNotificationTest, TriggerSqlNotifiesTableName) {
+    std::string sql = PgNotificationListener::invalidationTriggerSql("public.fx_rates");
+    EXPECT_NE(sql.find("CREATE TRIGGER hft_invalidate_public_fx_rates"), std::string::npos);
+    EXPECT_NE(sql.find("ON public.fx_rates"), std::string::npos);
+    EXPECT_NE(sql.find("pg_notify(TG_ARGV[0], TG_TABLE_NAME)"), std::string::npos);
+    EXPECT_NE(sql.find("hft_notify_invalidate('hft_invalidate')"), std::string::npos);
+}
+
+TEST(PgNotificationTest, InvalidatesOnTableChange) {
+    auto pg = openPgConnection();
+    if (!pg) {
+        GTEST_SKIP() << "PostgreSQL server not available";
+    }
+    pg->prepare("DROP TABLE IF EXISTS notify_test")->executeUpdate();
+    pg->prepare("CREATE TABLE notify_test (id int)")->executeUpdate();
+
+    auto listener = pg->createNotificationListener();
+    listener->installInvalidationTrigger("notify_test");
+
+    QueryResultCache::instance().put("notify_test:all", 1, std::chrono::hours(1), {"notify_test"});
+    std::vector<std::string> changed;
+    listener->onInvalidate("notify_test", [&](const std::string& table) { changed.push_back(table); });
+    listener->invalidateQueryCache("notify_test");
+
+    EXPECT_EQ(listener->poll(), 0);
+    pg->prepare("INSERT INTO notify_test VALUES (1)")->executeUpdate();
+
+    for (int i = 0; i < 100 && changed.empty(); ++i) {
+        listener->poll();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(changed.size(), 1u);
+    EXPECT_EQ(changed[0], "notify_test");
+    EXPECT_FALSE(QueryResultCache::instance().contains("notify_test:all"));
+
+    pg->prepare("DROP TABLE notify_test")->executeUpdate();
+}
+
+// Repository<Entity> against a connection that records statements and binds
+struct RepoQuote {
+    int id{};
+    std::string symbol;
+    double bid{};
+};
+
+template<>
+struct EntityTraits<RepoQuote> {
+    using Entity = RepoQuote;
+    static constexpr std::string_view tableName = "quotes";
+    static constexpr std::string_view primaryKey = "id";
+    static constexpr auto columns = std::make_tuple(
+        Column<Entity, int>{ "id", &Entity::id },
+        Column<Entity, std::string>{ "symbol", &Entity::symbol },
+        Column<Entity, double>{ "bid", &Entity::bid }
+    );
+};
+
+// Rows of text cells; an empty string reads as NULL
+class TextRowsReader : public IDBReader, public IDBRow {
+public:
+    explicit TextRowsReader(std::vector<std::vector<std::string>> rows) : _rows(std::move(rows)) {}
+    bool next() override { return ++_current < static_cast<int>(_rows.size()); }
+    IDBRow& row() override { return *this; }
+    std::size_t columnCount() const override { return _rows[_current].size(); }
+    const IDBValue& operator[](std::size_t idx) const override {
+        _value.text = _rows[_current][idx];
+        return _value;
+    }
+
+    int _current{-1};
+
+private:
+    struct TextValue : IDBValue {
+        bool isNull() const override { return text.empty(); }
+        int asInt() const override { return std::stoi(text); }
+        double asDouble() const override { return std::stod(text); }
+        std::string asString() const override { return text; }
+        std::string text;
+    };
+    std::vector<std::vector<std::string>> _rows;
+    mutable TextValue _value;
+};
+
+class RecordingStatement : public IDBPreparedStatement {
+public:
+    RecordingStatement(std::vector<std::string>& binds, const std::vector<std::vector<std::string>>& rows)
+        : _binds(binds), _rows(rows) {}
+    void bindInt(int index, int value) override { record(index, std::to_string(value)); }
+    void bindDouble(int index, double value) override { record(index, std::to_string(value)); }
+    void bindString(int index, const std::string& value) override { record(index, value); }
+    std::unique_ptr<IDBReader> executeQuery() override { return std::make_unique<TextRowsReader>(_rows); }
+    void executeUpdate() override {}
+
+private:
+    void record(int index, const std::string& value) {
+        _binds.push_back("$" + std::to_string(index) + "=" + value);
+    }
+    std::vector<std::string>& _binds;
+    const std::vector<std::vector<std::string>>& _rows;
+};
+
+// Rows written through beginBulkInsert(); NULLs are recorded as \N
+class RecordingBulkWriter : public IDBBulkWriter {
+public:
+    explicit RecordingBulkWriter(std::vector<std::vector<std::string>>& rows) : _rows(rows) {}
+    void startRow() override { _rows.emplace_back(); }
+    void writeNull() override { _rows.back().push_back("\\N"); }
+    void writeInt(int value) override { _rows.back().push_back(std::to_string(value)); }
+    void writeDouble(double value) override { _rows.back().push_back(std::to_string(value)); }
+    void writeString(const std::string& value) override { _rows.back().push_back(value); }
+    long finish() override { return static_cast<long>(_rows.size()); }
+
+private:
+    std::vector<std::vector<std::string>>& _rows;
+};
+
+class RecordingTransaction : public IDBTransaction {
+public:
+    void commit() override {}
+    void rollback() override {}
+};
+
+class RecordingConnection : public IDBConnection {
+public:
+    std::unique_ptr<IDBReader> executeQuery(const std::string& sql) override {
+        statements.push_back(sql);
+        auto reader = std::make_unique<TextRowsReader>(rows);
+        lastReader = reader.get();
+        return reader;
+    }
+    std::unique_ptr<IDBPreparedStatement> prepare(const std::string& sql) override {
+        statements.push_back(sql);
+        return std::make_unique<RecordingStatement>(binds, rows);
+    }
+    std::unique_ptr<IDBTransaction> beginTransaction() override { return std::make_unique<RecordingTransaction>(); }
+    bool supportsArrayParameters() const override { return arrays; }
+    std::unique_ptr<IDBBulkWriter>
+    beginBulkInsert(const std::string& table, const std::vector<std::string>& columns) override {
+        std::string sql = "COPY " + table + " (";
+        for (std::size_t i = 0; i < columns.size(); ++i) {
+            sql += (i ? ", " : "") + columns[i];
+        }
+        statements.push_back(sql + ")");
+        return std::make_unique<RecordingBulkWriter>(copied);
+    }
+
+    std::vector<std::string> statements;
+    std::vector<std::string> binds;
+    std::vector<std::vector<std::string>> rows;
+    std::vector<std::vector<std::string>> copied;
+    TextRowsReader* lastReader{nullptr};
+    bool arrays{false};
+};
+
+TEST(EntitySqlTest, GeneratesCrudStatementsAtCompileTime) {
+    static_assert(EntitySql<RepoQuote>::selectById.view() == "SELECT * FROM quotes WHERE id=$1");
+    EXPECT_EQ(EntitySql<RepoQuote>::selectAll.view(), "SELECT * FROM quotes");
+    EXPECT_EQ(EntitySql<RepoQuote>::insert.view(), "INSERT INTO quotes (symbol, bid) VALUES ($1, $2)");
+    EXPECT_EQ(EntitySql<RepoQuote>::update.view(), "UPDATE quotes SET symbol=$1, bid=$2 WHERE id=$3");
+    EXPECT_EQ(EntitySql<RepoQuote>::remove.view(), "DELETE FROM quotes WHERE id=$1");
+}
+
+TEST(EntitySqlTest, RepositoryBindsInsteadOfFormatting) {
+    RecordingConnection conn;
+    Repository<RepoQuote> repo(conn);
+    RepoQuote quote{7, "O'Neil", 1.5};
+
+    repo.update(quote);
+    repo.remove(quote);
+    repo.insert(quote);
+
+    ASSERT_EQ(conn.statements.size(), 3u);
+    EXPECT_EQ(conn.statements[0], "UPDATE quotes SET symbol=$1, bid=$2 WHERE id=$3");
+    EXPECT_EQ(conn.statements[1], "DELETE FROM quotes WHERE id=$1");
+    EXPECT_EQ(conn.statements[2], "INSERT INTO quotes (symbol, bid) VALUES ($1, $2)");
+    EXPECT_EQ(conn.binds, (std::vector<std::string>{"$1=O'Neil", "$2=1.500000", "$3=7",
+                                                    "$1=7",
+                                                    "$1=O'Neil", "$2=1.500000"}));
+}
+
+TEST(EntitySqlTest, RepositoryCopyWritesFieldValues) {
+    RecordingConnection conn;
+    Repository<RepoQuote> repo(conn);
+    repo.setBatchInsertMode(BatchInsertMode::Copy);
+
+    repo.insertBatch({{1, "EURUSD", 1.25}, {2, "USDJPY", 150}});
+
+    EXPECT_EQ(conn.statements.back(), "COPY quotes (symbol, bid)");
+    EXPECT_EQ(conn.copied, (std::vector<std::vector<std::string>>{{"EURUSD", "1.250000"},
+                                                                  {"USDJPY", "150.000000"}}));
+}
+
+TEST(EntitySqlTest, RepositoryMultiRowBindsEveryRow) {
+    RecordingConnection conn;
+    Repository<RepoQuote> repo(conn);
+    repo.setBatchInsertMode(BatchInsertMode::MultiRow);
+
+    repo.insertBatch({{1, "EURUSD", 1.25}, {2, "USDJPY", 150}, {3, "GBPUSD", 1.5}});
+
+    // Three rows go out as chunks of two and one
+    ASSERT_EQ(conn.statements.size(), 2u);
+    EXPECT_EQ(conn.statements[0], "INSERT INTO quotes (symbol, bid) VALUES ($1, $2), ($3, $4)");
+    EXPECT_EQ(conn.statements[1], "INSERT INTO quotes (symbol, bid) VALUES ($1, $2)");
+    EXPECT_EQ(conn.binds, (std::vector<std::string>{"$1=EURUSD", "$2=1.250000", "$3=USDJPY", "$4=150.000000",
+                                                    "$1=GBPUSD", "$2=1.500000"}));
+}
+
+TEST(EntitySqlTest, RepositoryStreamReusesOneEntity) {
+    RecordingConnection conn;
+    conn.rows = {{"1", "EURUSD", "1.25"}, {"2", "", "0.5"}, {"3", "USDJPY", "150"}};
+    Repository<RepoQuote> repo(conn);
+
+    auto stream = repo.stream();
+    std::vector<std::string> symbols;
+    const RepoQuote* entity = nullptr;
+    for (const auto& quote : stream) {
+        if (!entity) entity = &quote;
+        EXPECT_EQ(entity, &quote);
+        symbols.push_back(quote.symbol);  // NULL must not keep the previous row's value
+        if (quote.id == 2) break;
+    }
+    EXPECT_EQ(symbols, (std::vector<std::string>{"EURUSD", ""}));
+    EXPECT_EQ(conn.lastReader->_current, 1);
+    EXPECT_EQ(conn.statements.back(), "SELECT * FROM quotes");
+}
+
+TEST(EntitySqlTest, FindByIdsAlignsResultsWithInput) {
+    RecordingConnection conn;
+    conn.rows = {{"5", "EURUSD", "1.25"}, {"2", "USDJPY", "150"}};
+    Repository<RepoQuote> repo(conn);
+
+    auto quotes = repo.findByIds({2, 9, 5, 2});
+    ASSERT_EQ(quotes.size(), 4u);
+    EXPECT_EQ(quotes[0]->symbol, "USDJPY");
+    EXPECT_FALSE(quotes[1].has_value());
+    EXPECT_EQ(quotes[2]->symbol, "EURUSD");
+    EXPECT_EQ(quotes[3]->symbol, "USDJPY");
+    EXPECT_EQ(conn.statements.back(), "SELECT * FROM quotes WHERE id IN ($1, $2, $3)");
+    EXPECT_EQ(conn.binds, (std::vector<std::string>{"$1=2", "$2=5", "$3=9"}));
+
+    conn.arrays = true;
+    conn.binds.clear();
+    quotes = repo.findByIds({9, 5});
+    EXPECT_FALSE(quotes[0].has_value());
+    EXPECT_EQ(quotes[1]->id, 5);
+    EXPECT_EQ(conn.statements.back(), "SELECT * FROM quotes WHERE id = ANY($1::int4[])");
+    EXPECT_EQ(conn.binds, (std::vector<std::string>{"$1={5,9}"}));
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
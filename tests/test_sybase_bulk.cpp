@@ -0,0 +1,257 @@
+#include <gtest/gtest.h>
+#include "hft/sybase/SybBcpApi.hpp"
+#include "hft/sybase/SybBcpReader.hpp"
+#include "hft/sybase/SybBcpWriter.hpp"
+#include "hft/sybase/SybSqlTemplate.hpp"
+#include "hft/sybase/SybValue.hpp"
+#include "hft/db/IDBValue.hpp"
+#include "hft/db/DBException.hpp"
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+
+// Records the DB-Lib bulk-copy calls instead of talking to a server
+class MockBcpApi : public ISybBcpApi {
+public:
+    struct Sent {
+        bool isNull;
+        std::string bytes;
+    };
+
+    std::vector<std::string> tableColumns(const std::string&) override { return columns; }
+
+    bool init(const std::string& table, const std::string& file, bool out) override {
+        initTable = table;
+        hostFile = file;
+        directionOut = out;
+        return true;
+    }
+
+    bool bind(int tableColumn, SybBcpType type) override {
+        bound.emplace_back(tableColumn, type);
+        return true;
+    }
+
+    bool setColumn(int tableColumn, const void* data, int length) override {
+        current[tableColumn] = data ? Sent{false, std::string(static_cast<const char*>(data), length)}
+                                    : Sent{true, {}};
+        return true;
+    }
+
+    bool sendRow() override {
+        rows.push_back(current);
+        current.clear();
+        return true;
+    }
+
+    long batch() override { ++batches; return 0; }
+    long done() override { ++dones; return 0; }
+    void cancel() override {
+        ++cancels;
+        if (cancelled) *cancelled = true;
+    }
+
+    bool setHostColumns(int count) override { hostColumns = count; return true; }
+    bool setHostFormat(int, int) override { ++hostFormats; return true; }
+
+    long exec() override {
+        std::ofstream out(hostFile, std::ios::binary);
+        for (const auto& field : exportFields) {
+            std::int32_t length = static_cast<std::int32_t>(field.size());
+            out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+            out.write(field.data(), length);
+        }
+        return static_cast<long>(exportFields.size() / columns.size());
+    }
+
+    std::vector<std::string> columns;
+    std::vector<std::string> exportFields;
+    std::string initTable;
+    std::string hostFile;
+    bool directionOut{false};
+    std::vector<std::pair<int, SybBcpType>> bound;
+    std::map<int, Sent> current;
+    std::vector<std::map<int, Sent>> rows;
+    int batches{0};
+    int dones{0};
+    int cancels{0};
+    bool* cancelled{nullptr};  // observable after the owning writer is gone
+    int hostColumns{0};
+    int hostFormats{0};
+};
+
+TEST(SybBcpWriterTest, BindsFromFirstRowAndBatches) {
+    auto api = std::make_unique<MockBcpApi>();
+    api->columns = {"id", "side", "price"};
+    MockBcpApi* mock = api.get();
+
+    // Loaded columns in a different order than the table
+    SybBcpWriter writer(std::move(api), "fx_trades", {"price", "id", "side"}, 2);
+    EXPECT_EQ(mock->initTable, "fx_trades");
+    EXPECT_FALSE(mock->directionOut);
+
+    writer.startRow();
+    writer.writeDouble(1.25);
+    writer.writeInt(7);
+    writer.writeString("BUY");
+    writer.startRow();
+    writer.writeInt(2);          // widened into the double column
+    writer.writeInt(8);
+    writer.writeNull();
+    writer.startRow();
+    writer.writeDouble(3.5);
+    writer.writeNull();
+    writer.writeString("SELL");
+    EXPECT_EQ(writer.finish(), 3);
+
+    ASSERT_EQ(mock->bound.size(), 3u);
+    EXPECT_EQ(mock->bound[0], std::make_pair(3, SybBcpType::Float));
+    EXPECT_EQ(mock->bound[1], std::make_pair(1, SybBcpType::Int));
+    EXPECT_EQ(mock->bound[2], std::make_pair(2, SybBcpType::Char));
+
+    ASSERT_EQ(mock->rows.size(), 3u);
+    double price = 0;
+    std::memcpy(&price, mock->rows[1][3].bytes.data(), sizeof(price));
+    EXPECT_DOUBLE_EQ(price, 2.0);
+    EXPECT_TRUE(mock->rows[1][2].isNull);
+    EXPECT_TRUE(mock->rows[2][1].isNull);
+    EXPECT_EQ(mock->rows[2][2].bytes, "SELL");
+
+    EXPECT_EQ(mock->batches, 1);
+    EXPECT_EQ(mock->dones, 1);
+    EXPECT_EQ(mock->cancels, 0);
+}
+
+TEST(SybBcpWriterTest, RejectsTypeChangesAndCancelsWhenAbandoned) {
+    auto api = std::make_unique<MockBcpApi>();
+    api->columns = {"id"};
+    bool cancelled = false;
+    api->cancelled = &cancelled;
+    {
+        SybBcpWriter writer(std::move(api), "t", {"id"});
+        writer.startRow();
+        writer.writeInt(1);
+        writer.startRow();
+        writer.writeString("x");
+        EXPECT_THROW(writer.startRow(), DBException);
+    }
+    EXPECT_TRUE(cancelled);
+}
+
+TEST(SybBcpWriterTest, UnknownColumnThrows) {
+    auto api = std::make_unique<MockBcpApi>();
+    api->columns = {"id"};
+    EXPECT_THROW(SybBcpWriter(std::move(api), "t", {"missing"}), DBException);
+}
+
+TEST(SybBcpReaderTest, StreamsRowsFromHostFile) {
+    auto api = std::make_unique<MockBcpApi>();
+    api->columns = {"id", "side"};
+    api->exportFields = {"1", "BUY", "2", ""};
+    MockBcpApi* mock = api.get();
+
+    std::string hostFile;
+    {
+        SybBcpReader reader(std::move(api), "fx_trades");
+        hostFile = mock->hostFile;
+        EXPECT_TRUE(mock->directionOut);
+        EXPECT_EQ(mock->hostColumns, 2);
+        EXPECT_EQ(mock->hostFormats, 2);
+        EXPECT_EQ(reader.rowCount(), 2);
+        EXPECT_TRUE(std::filesystem::exists(hostFile));
+
+        ASSERT_TRUE(reader.next());
+        EXPECT_EQ(reader.row()[0].asInt(), 1);
+        EXPECT_EQ(reader.row()[1].asString(), "BUY");
+        ASSERT_TRUE(reader.next());
+        EXPECT_EQ(reader.row()[0].asInt(), 2);
+        EXPECT_TRUE(reader.row()[1].isNull());
+        EXPECT_FALSE(reader.next());
+    }
+    EXPECT_FALSE(std::filesystem::exists(hostFile));
+}
+
+TEST(SybValueTest, ViewsBoundBuffersInPlace) {
+    // Stand-ins for the dbbind()/dbnullbind() buffers SybRow registers
+    std::int32_t indicator = 0;
+    std::int64_t bigValue = 9007199254740993LL;
+    double price = 0.1 + 0.2;
+    char text[16] = "EURUSD";
+
+    SybValue big, dbl, str;
+    big.bindInt64(&bigValue, &indicator);
+    dbl.bindDouble(&price, nullptr);
+    str.bindText(text, nullptr);
+
+    EXPECT_EQ(big.asInt64(), 9007199254740993LL);   // no SYBINT4 truncation
+    EXPECT_EQ(big.asString(), "9007199254740993");
+    EXPECT_EQ(dbl.asDouble(), 0.1 + 0.2);           // no std::to_string rounding
+    EXPECT_EQ(str.asStringView(), "EURUSD");
+
+    // The next dbnextrow() rewrites the buffers; the views follow
+    bigValue = 7;
+    std::strcpy(text, "GBPUSD");
+    indicator = -1;
+    EXPECT_TRUE(big.isNull());
+    EXPECT_EQ(str.asString(), "GBPUSD");
+    indicator = 0;
+    EXPECT_EQ(big.asInt(), 7);
+}
+
+TEST(SybValueTest, RejectsValuesOutsideTheTargetRange) {
+    std::int64_t bigValue = 3000000000LL;
+    double price = 1e300;
+
+    SybValue big, dbl;
+    big.bindInt64(&bigValue, nullptr);
+    dbl.bindDouble(&price, nullptr);
+
+    EXPECT_THROW(big.asInt(), DBException);         // BIGINT past INT_MAX
+    EXPECT_EQ(big.asInt64(), 3000000000LL);
+    EXPECT_THROW(dbl.asInt64(), DBException);
+    price = -2.9;
+    EXPECT_EQ(dbl.asInt(), -2);
+}
+
+static SybSqlParam intParam(std::int32_t value) {
+    SybSqlParam p;
+    p.type = SybSqlParam::Type::Int;
+    p.intValue = value;
+    return p;
+}
+
+static SybSqlParam stringParam(const std::string& value) {
+    SybSqlParam p;
+    p.type = SybSqlParam::Type::String;
+    p.text = value;
+    return p;
+}
+
+TEST(SybSqlTemplateTest, SplitsPlaceholdersOutsideQuotes) {
+    SybSqlTemplate sql("select '$1', \"$2\", $0, $10 from t where a = $1 and b = $2");
+    EXPECT_EQ(sql.rpcBody(), "select '$1', \"$2\", $0, @p10 from t where a = @p1 and b = @p2");
+
+    std::vector<SybSqlParam> params(10);
+    params[0] = intParam(7);
+    params[1] = stringParam("O'Neil");
+    params[9] = intParam(-3);
+    EXPECT_EQ(sql.render(params), "select '$1', \"$2\", $0, -3 from t where a = 7 and b = 'O''Neil'");
+}
+
+TEST(SybSqlTemplateTest, LeavesUnboundSlotsForTheServer) {
+    SybSqlTemplate sql("update t set a = $1, b = $2, c = $3");
+
+    // $2 is inside the parameter list but never bound; $3 is past its end
+    std::vector<SybSqlParam> params(2);
+    params[0] = intParam(1);
+    EXPECT_EQ(sql.render(params), "update t set a = 1, b = $2, c = $3");
+    EXPECT_EQ(SybSqlTemplate("select 1").render({}), "select 1");
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}